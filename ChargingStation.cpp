@@ -1,31 +1,33 @@
 #include "./ChargingStation.h"
 
 // Constructor
-ChargingStation::ChargingStation(int numberOfChargingSlots) : cNumberOfChargingSlots(numberOfChargingSlots){}
+ChargingStation::ChargingStation(int numberOfChargingSlots) : cNumberOfChargingSlots(numberOfChargingSlots) {
+    chargers.reserve(numberOfChargingSlots);
+}
 
 // Add an IChargeable to the waitQueue
 void ChargingStation::addVehicle(shared_ptr<IChargeable> chargeable) {
-    waitQueue.push(chargeable);
     chargeable->setInWaitQueue();
+    waitQueue.push(std::move(chargeable));
 }
 
 // Process the charge slots and wait queue
 void ChargingStation::iterate() {
     // Check who's done charging and remove them
-    for (std::set<shared_ptr<IChargeable>>::iterator it = chargers.begin(); it != chargers.end();) {
-        if (!(*it)->isCharging()) {
-            it = chargers.erase(it); // No longer charging so remove from charging station
+    for (size_t slot = 0; slot < chargers.size();) {
+        if (!chargers[slot]->isCharging()) {
+            chargers[slot] = std::move(chargers.back()); // No longer charging so remove from charging station
+            chargers.pop_back();
         } else {
-            ++it;
+            ++slot;
         }
     }
 
     // Add vehicles to the charger if possible
     while (!waitQueue.empty() && chargers.size() < cNumberOfChargingSlots) {
-        shared_ptr<IChargeable> v = waitQueue.front();
+        chargers.push_back(std::move(waitQueue.front()));
         waitQueue.pop();
-        chargers.insert(v);
-        v->setCharging();
+        chargers.back()->setCharging();
     }
 }
 
@@ -1,8 +1,9 @@
 #ifndef _CHARGING_STATION_H
 #define _CHARGING_STATION_H
 
+#include <memory>
 #include <queue>
-#include <set>
+#include <vector>
 #include "./IChargeable.h"
 
 using std::shared_ptr;
@@ -13,7 +14,7 @@ private:
     const int cNumberOfChargingSlots;
 
     std::queue<shared_ptr<IChargeable>> waitQueue;
-    std::set<shared_ptr<IChargeable>> chargers;
+    std::vector<shared_ptr<IChargeable>> chargers;  // Never grows past cNumberOfChargingSlots
 
 public:
     // Only initialization state is the number of charging slots
@@ -29,6 +30,9 @@ public:
 
     // Iterate manages the charging slots and wait queue
     void iterate();
+
+    size_t getNumberCharging() const { return chargers.size(); }
+    size_t getNumberWaiting() const { return waitQueue.size(); }
 };
 
 #endif //_CHARGING_STATION_H
\ No newline at end of file
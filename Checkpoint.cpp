@@ -0,0 +1,156 @@
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "./Checkpoint.h"
+
+namespace {
+
+const char cMagic[8] = {'J', 'O', 'B', 'Y', 'C', 'K', 'P', '\0'};
+const uint32_t cVersion = 4;
+const uint32_t cByteOrderMark = 0x01020304;
+
+}
+
+CheckpointWriter::CheckpointWriter(const std::string& path) :
+        file(path, std::ios::binary | std::ios::trunc)
+{}
+
+bool CheckpointWriter::isOpen() const {
+    return static_cast<bool>(file);
+}
+
+void CheckpointWriter::write(const void* data, size_t size) {
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+void CheckpointWriter::writeString(const std::string& text) {
+    write(static_cast<uint32_t>(text.size()));
+    write(text.data(), text.size());
+}
+
+bool CheckpointWriter::close() {
+    file.close();
+    return !file.fail();
+}
+
+CheckpointReader::CheckpointReader(const std::string& path) :
+        data(nullptr),
+        size(0),
+        offset(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat status;
+    if (fstat(fd, &status) == 0 && status.st_size > 0) {
+        void* mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            data = static_cast<const char*>(mapping);
+            size = static_cast<size_t>(status.st_size);
+            // The file is read front to back once
+            madvise(mapping, size, MADV_SEQUENTIAL);
+        }
+    }
+    ::close(fd);
+}
+
+CheckpointReader::~CheckpointReader() {
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
+
+bool CheckpointReader::fail(const std::string& reason) {
+    if (error.empty()) {
+        error = reason;
+    }
+    return false;
+}
+
+bool CheckpointReader::read(void* destination, size_t length) {
+    if (!ok()) {
+        return false;
+    }
+    if (length > size - offset) {
+        return fail("truncated checkpoint");
+    }
+    std::memcpy(destination, data + offset, length);
+    offset += length;
+    return true;
+}
+
+bool CheckpointReader::readString(std::string& text) {
+    uint32_t length;
+    if (!read(length)) {
+        return false;
+    }
+    if (length > size - offset) {
+        return fail("truncated checkpoint");
+    }
+    text.assign(data + offset, length);
+    offset += length;
+    return true;
+}
+
+bool saveCheckpoint(const std::string& path, const FleetClock& clock, const FleetState& fleet,
+                    const StationNetwork& stations, std::string& error) {
+    CheckpointWriter writer(path);
+    if (!writer.isOpen()) {
+        error = path + ": can't open checkpoint file";
+        return false;
+    }
+
+    writer.write(cMagic, sizeof(cMagic));
+    writer.write(cVersion);
+    writer.write(cByteOrderMark);
+    writer.write(clock.currentTime);
+    writer.write(static_cast<uint64_t>(clock.totalIterations));
+    fleet.save(writer);
+    stations.save(writer);
+
+    if (!writer.close()) {
+        error = path + ": can't write checkpoint file";
+        return false;
+    }
+    return true;
+}
+
+bool loadCheckpoint(const std::string& path, FleetClock& clock, FleetState& fleet, StationNetwork& stations,
+                    std::string& error) {
+    CheckpointReader reader(path);
+    if (!reader.isOpen()) {
+        error = path + ": can't open checkpoint file";
+        return false;
+    }
+
+    char magic[sizeof(cMagic)];
+    uint32_t version = 0;
+    uint32_t byteOrderMark = 0;
+    uint64_t totalIterations = 0;
+    if (!reader.read(magic, sizeof(magic)) || std::memcmp(magic, cMagic, sizeof(cMagic)) != 0) {
+        error = path + ": not a checkpoint file";
+        return false;
+    }
+    if (reader.read(version) && version != cVersion) {
+        error = path + ": unsupported checkpoint version " + std::to_string(version);
+        return false;
+    }
+    if (reader.read(byteOrderMark) && byteOrderMark != cByteOrderMark) {
+        error = path + ": checkpoint was written on a machine with a different byte order";
+        return false;
+    }
+    reader.read(clock.currentTime);
+    reader.read(totalIterations);
+    clock.totalIterations = static_cast<unsigned long>(totalIterations);
+
+    if (!reader.ok() || !fleet.restore(reader) || !stations.restore(reader, fleet)) {
+        error = path + ": " + reader.getError();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,134 @@
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "./FleetState.h"
+#include "./StationNetwork.h"
+
+// Where a fleet engine run is up to. With the FleetState and StationNetwork this is everything needed
+// to continue the run.
+struct FleetClock {
+    double currentTime;              // World time minutes
+    unsigned long totalIterations;   // Passes made over the fleet so far
+};
+
+// Writes the sections of a checkpoint file. Values and arrays are written as their native bytes, so a
+// checkpoint can only be restored on a machine with the same byte order and type sizes (checked by
+// the file header).
+class CheckpointWriter {
+private:
+    std::ofstream file;
+
+public:
+    // Open path for writing, check isOpen() before use
+    explicit CheckpointWriter(const std::string& path);
+
+    // Prevent unneeded defaults
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    bool isOpen() const;
+
+    void write(const void* data, size_t size);
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values are written as raw bytes");
+        write(&value, sizeof(T));
+    }
+
+    // A uint64 count followed by the elements
+    template <typename T>
+    void writeArray(const vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values are written as raw bytes");
+        write(static_cast<uint64_t>(values.size()));
+        write(values.data(), values.size() * sizeof(T));
+    }
+
+    void writeString(const std::string& text);
+
+    // Flush to disk, returns false if anything failed to write
+    bool close();
+};
+
+// Reads the sections of a checkpoint file. The file is mapped into memory and arrays are copied
+// straight out of the mapping. Reads past the end of the file fail rather than crash, and the first
+// failure is kept in getError().
+class CheckpointReader {
+private:
+    const char* data;
+    size_t size;
+    size_t offset;
+    std::string error;
+
+public:
+    // Map path for reading, check isOpen() before use
+    explicit CheckpointReader(const std::string& path);
+
+    // Unmaps the file
+    ~CheckpointReader();
+
+    // Prevent unneeded defaults
+    CheckpointReader(const CheckpointReader&) = delete;
+    CheckpointReader& operator=(const CheckpointReader&) = delete;
+
+    bool isOpen() const { return data != nullptr; }
+
+    // Record a failure, returns false so callers can "return reader.fail(...)"
+    bool fail(const std::string& reason);
+    bool ok() const { return error.empty(); }
+    const std::string& getError() const { return error; }
+
+    bool read(void* destination, size_t length);
+
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values are read as raw bytes");
+        return read(&value, sizeof(T));
+    }
+
+    // An array written by CheckpointWriter::writeArray(), values is resized to fit
+    template <typename T>
+    bool readArray(vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values are read as raw bytes");
+        uint64_t count;
+        if (!read(count)) {
+            return false;
+        }
+        // Check the length before resizing so a corrupt count can't allocate the world
+        if (count > (size - offset) / sizeof(T)) {
+            return fail("truncated checkpoint");
+        }
+        values.resize(static_cast<size_t>(count));
+        return read(values.data(), values.size() * sizeof(T));
+    }
+
+    bool readString(std::string& text);
+};
+
+// Write a checkpoint of a fleet engine run to path. Returns false with a message in error if the file
+// can't be written.
+//
+// The file is an 8 byte "JOBYCKP" magic, then uint32 version and a uint32 byte order mark, the
+// FleetClock, the FleetState (model table, fault settings, every per vehicle array and the charging
+// sessions recorded so far) and the StationNetwork (charging slots and wait queue ends of each station,
+// the station of each vehicle and the routing policy state). Arrays are a uint64 count followed by their
+// elements.
+bool saveCheckpoint(const std::string& path, const FleetClock& clock, const FleetState& fleet,
+                    const StationNetwork& stations, std::string& error);
+
+// Restore a checkpoint written by saveCheckpoint() into an empty fleet and a new network built from the
+// same scenario: the models, number of stations, charging slots and routing must match the run that was
+// saved. Continuing from the restored clock gives the same results, bit for bit, as a run that was never
+// stopped. Returns false with a "path: reason" message in error if the file can't be read or doesn't
+// match.
+bool loadCheckpoint(const std::string& path, FleetClock& clock, FleetState& fleet, StationNetwork& stations,
+                    std::string& error);
+
+#endif //_CHECKPOINT_H
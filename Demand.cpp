@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include "./Demand.h"
+
+using std::cout;
+
+namespace {
+
+// Keeps the request draws apart from the fleet's draws, which are made from the same seed
+const unsigned long cRequestDraws = 0x2545F491UL;
+
+// "hh:mm" into minutes into the day
+bool parseClock(const std::string& text, double& minutes) {
+    size_t colon = text.find(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == text.size() || text[0] == '-') {
+        return false;
+    }
+    char* end;
+    errno = 0;
+    unsigned long hours = std::strtoul(text.c_str(), &end, 10);
+    if (errno != 0 || end != text.c_str() + colon || text[colon + 1] == '-') {
+        return false;
+    }
+    unsigned long minute = std::strtoul(text.c_str() + colon + 1, &end, 10);
+    if (errno != 0 || *end != '\0' || hours > 23 || minute > 59) {
+        return false;
+    }
+    minutes = static_cast<double>(hours * 60 + minute);
+    return true;
+}
+
+}
+
+const double DemandProfile::cDay = 24.0 * 60.0;
+
+DemandProfile::DemandProfile() :
+        requestsPerDay(0.0)
+{}
+
+void DemandProfile::addRate(double startTime, double requestsPerHour) {
+    assert(startTime >= 0.0 && startTime < cDay && requestsPerHour >= 0.0);
+    assert(startTimes.empty() || startTime > startTimes.back());
+    startTimes.push_back(startTime);
+    rates.push_back(requestsPerHour / 60.0);
+
+    // Each rate runs up to the next one, the last one through midnight to the first
+    requestsPerDay = 0.0;
+    for (size_t r = 0; r < rates.size(); ++r) {
+        double end = r + 1 < startTimes.size() ? startTimes[r + 1] : cDay + startTimes[0];
+        requestsPerDay += (end - startTimes[r]) * rates[r];
+    }
+}
+
+bool DemandProfile::load(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = path + ": can't open";
+        return false;
+    }
+
+    DemandProfile profile;
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::istringstream fields(line.substr(0, line.find_first_of(";#")));
+        std::string clock;
+        std::string rate;
+        std::string extra;
+        if (!(fields >> clock)) {
+            continue;
+        }
+        double startTime;
+        double requestsPerHour;
+        if (!(fields >> rate) || (fields >> extra) || !parseClock(clock, startTime)) {
+            error = path + ":" + std::to_string(lineNumber) + ": expected hh:mm requests-per-hour";
+            return false;
+        }
+        char* end;
+        errno = 0;
+        requestsPerHour = std::strtod(rate.c_str(), &end);
+        if (errno != 0 || *end != '\0' || requestsPerHour < 0.0 || std::isinf(requestsPerHour)) {
+            error = path + ":" + std::to_string(lineNumber) + ": bad requests per hour " + rate;
+            return false;
+        }
+        if (!profile.startTimes.empty() && startTime <= profile.startTimes.back()) {
+            error = path + ":" + std::to_string(lineNumber) + ": times must be in order";
+            return false;
+        }
+        profile.addRate(startTime, requestsPerHour);
+    }
+
+    if (profile.startTimes.empty()) {
+        error = path + ": no rates";
+        return false;
+    }
+    *this = profile;
+    return true;
+}
+
+double DemandProfile::rate(double time) const {
+    if (rates.empty()) {
+        return 0.0;
+    }
+    double position = time - std::floor(time / cDay) * cDay;
+    size_t next = static_cast<size_t>(std::upper_bound(startTimes.begin(), startTimes.end(), position) -
+                                      startTimes.begin());
+    // Before the first change of the day the last rate of the day before is still in effect
+    return rates[next == 0 ? rates.size() - 1 : next - 1];
+}
+
+double DemandProfile::timeAfter(double time, double requests) const {
+    if (requestsPerDay <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    // Skip whole days, then walk the rates up to the one the requests run out in
+    double days = std::floor(requests / requestsPerDay);
+    requests -= days * requestsPerDay;
+    double day = (std::floor(time / cDay) + days) * cDay;
+    double position = time - std::floor(time / cDay) * cDay;
+    size_t next = static_cast<size_t>(std::upper_bound(startTimes.begin(), startTimes.end(), position) -
+                                      startTimes.begin());
+    while (true) {
+        const double rate = rates[next == 0 ? rates.size() - 1 : next - 1];
+        const double end = next < startTimes.size() ? startTimes[next] : cDay;
+        const double expected = (end - position) * rate;
+        if (rate > 0.0 && requests <= expected) {
+            return day + position + requests / rate;
+        }
+        requests -= expected;
+        position = end;
+        if (next < startTimes.size()) {
+            ++next;
+        } else {
+            day += cDay;
+            position = 0.0;
+            next = 0;
+        }
+    }
+}
+
+FleetDemand::FleetDemand(const DemandProfile& profile, unsigned long seed) :
+        cProfile(profile),
+        rng(seed ^ cRequestDraws),
+        nextRequest(0.0),
+        requests(0),
+        served(0),
+        totalWait(0.0),
+        longestWait(0.0)
+{
+    // Exponential gaps in expected requests, run through the profile's rate
+    nextRequest = cProfile.timeAfter(0.0, -std::log1p(-rng.uniform()));
+}
+
+void FleetDemand::dispatch(double time, FleetState& fleet) {
+    while (nextRequest <= time) {
+        waiting.push_back(nextRequest);
+        ++requests;
+        nextRequest = cProfile.timeAfter(nextRequest, -std::log1p(-rng.uniform()));
+    }
+
+    while (!waiting.empty() && fleet.numberParked() > 0) {
+        const double wait = time - waiting.front();
+        waiting.pop_front();
+        fleet.wake();
+        ++served;
+        totalWait += wait;
+        longestWait = std::max(longestWait, wait);
+    }
+}
+
+double FleetDemand::getAverageWait() const {
+    return served > 0 ? totalWait / static_cast<double>(served) : 0.0;
+}
+
+void FleetDemand::printReport() const {
+    cout << "Demand, requests/served/waiting/average-wait(mins)/longest-wait(mins): " << requests << "/" << served
+         << "/" << waiting.size() << "/" << getAverageWait() << "/" << longestWait << "\n";
+}
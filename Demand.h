@@ -0,0 +1,91 @@
+#ifndef _DEMAND_H
+#define _DEMAND_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "./FleetState.h"
+#include "./RandomStream.h"
+
+// Trip requests by time of day, for a fleet engine run with a parked fleet (see FleetState::enableDemand()).
+//
+// A DemandProfile is a piecewise constant rate of trip requests that repeats every day, world time 0 being
+// midnight. It is loaded from a file with one "hh:mm requests-per-hour" line for each change of rate, in
+// order, ';' or '#' start comments:
+//
+//   00:00  20     ; quiet until the morning
+//   07:00  900
+//   10:00  300
+//   16:30  1200
+//   19:30  300
+//   23:00  60
+//
+// The last rate carries on through midnight up to the first change of the next day.
+class DemandProfile {
+private:
+    static const double cDay;          // World time minutes in a day
+
+    std::vector<double> startTimes;    // Minutes into the day each rate starts at, in order
+    std::vector<double> rates;         // Requests per world time minute
+    double requestsPerDay;
+
+public:
+    // No requests at all, until load() or addRate()
+    DemandProfile();
+
+    // Add a rate of requestsPerHour from startTime minutes into the day, after the ones already added
+    void addRate(double startTime, double requestsPerHour);
+
+    // Replace the profile with the one in a file. Returns false with a "file:line: reason" message in
+    // error if it can't be read or parsed.
+    bool load(const std::string& path, std::string& error);
+
+    // Requests per world time minute at a world time
+    double rate(double time) const;
+
+    // Requests expected over a whole day
+    double getRequestsPerDay() const { return requestsPerDay; }
+
+    // The world time after time by which the expected number of requests reaches requests, infinite if
+    // the rate is 0 all day. Turns a unit rate process into this profile's.
+    double timeAfter(double time, double requests) const;
+};
+
+// Trip requests arrive as a Poisson process at the profile's rate and each one wakes a parked vehicle.
+// Requests that come in while nothing is parked wait for the next vehicle to park, oldest first.
+class FleetDemand {
+private:
+    const DemandProfile cProfile;
+    RandomStream rng;
+    double nextRequest;                 // World time of the next request to arrive
+
+    std::deque<double> waiting;         // Arrival times of the requests waiting for a vehicle
+
+    uint64_t requests;
+    uint64_t served;
+    double totalWait;                   // World time minutes from request to take off, served requests
+    double longestWait;
+
+public:
+    FleetDemand(const DemandProfile& profile, unsigned long seed);
+
+    // Prevent unneeded defaults
+    FleetDemand(const FleetDemand&) = delete;
+    FleetDemand& operator=(const FleetDemand&) = delete;
+
+    // Wake a parked vehicle for every request that has arrived by time, call at the start of each pass
+    void dispatch(double time, FleetState& fleet);
+
+    uint64_t getRequests() const { return requests; }
+    uint64_t getServed() const { return served; }
+    size_t getWaiting() const { return waiting.size(); }
+    double getAverageWait() const;
+    double getLongestWait() const { return longestWait; }
+
+    // Print the requests, the ones served and their waits
+    void printReport() const;
+};
+
+#endif //_DEMAND_H
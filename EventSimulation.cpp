@@ -0,0 +1,77 @@
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include "./EventSimulation.h"
+
+namespace {
+
+// A vehicle finishing its current operation (flight or charge)
+struct Event {
+    double time;           // World time (simulated minutes)
+    unsigned long sequence; // Breaks ties in the order events were scheduled
+    size_t vehicle;        // Index into the vehicles vector
+
+    bool operator>(const Event& other) const {
+        return time > other.time || (time == other.time && sequence > other.sequence);
+    }
+};
+
+typedef std::priority_queue<Event, vector<Event>, std::greater<Event>> EventQueue;
+
+}
+
+unsigned long runEventLoop(vector<shared_ptr<Vehicle>>& vehicles, ChargingStation& chargingStation, double runTime) {
+    EventQueue events;
+    unsigned long sequence = 0;
+
+    // World time of the last time each vehicle was advanced
+    vector<double> lastUpdate(vehicles.size(), 0.0);
+
+    // Mirror of the charging station's FIFO wait queue, used to find out which vehicles the
+    // station started charging.
+    std::queue<size_t> queued;
+
+    for (size_t i = 0; i < vehicles.size(); ++i) {
+        events.push({vehicles[i]->timeRemaining(), sequence++, i});
+    }
+
+    unsigned long totalEvents = 0;
+    while (!events.empty() && events.top().time < runTime) {
+        Event event = events.top();
+        events.pop();
+        double now = event.time;
+
+        // Finish the flight or charge
+        shared_ptr<Vehicle>& v = vehicles[event.vehicle];
+        v->advance(v->timeRemaining());
+        lastUpdate[event.vehicle] = now;
+
+        if (v->isWaitingForQueue()) {
+            chargingStation.addVehicle(v);
+            queued.push(event.vehicle);
+        } else {
+            // Back in the air
+            events.push({now + v->timeRemaining(), sequence++, event.vehicle});
+        }
+
+        // Frees the slot of a vehicle that is done charging and starts charging queued vehicles
+        chargingStation.iterate();
+        while (!queued.empty() && vehicles[queued.front()]->isCharging()) {
+            size_t i = queued.front();
+            queued.pop();
+            vehicles[i]->addWaitTime(now - lastUpdate[i]);
+            lastUpdate[i] = now;
+            events.push({now + vehicles[i]->timeRemaining(), sequence++, i});
+        }
+
+        ++totalEvents;
+    }
+
+    // Account for the partial operations that are still in progress at the end of the run
+    for (size_t i = 0; i < vehicles.size(); ++i) {
+        vehicles[i]->advance(runTime - lastUpdate[i]);
+    }
+
+    return totalEvents;
+}
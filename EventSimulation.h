@@ -0,0 +1,27 @@
+#ifndef _EVENT_SIMULATION_H
+#define _EVENT_SIMULATION_H
+
+#include <memory>
+#include <vector>
+
+#include "./Vehicle.h"
+#include "./ChargingStation.h"
+
+using std::shared_ptr;
+using std::vector;
+
+// Discrete event version of the simulation loop.
+//
+// Instead of iterating every vehicle on every increment, the next state change of each vehicle
+// (end of flight after the model endurance, end of charging after timeToCharge) is kept in a
+// priority queue and world time jumps straight from one change to the next. Freeing a charging
+// slot is handled at the moment a vehicle stops charging. Each state change costs O(log n).
+//
+// Times are accounted exactly, whereas the tick loop loses up to one increment at every state
+// change. Per model totals agree with runTickLoop() to within about one increment per state
+// change per vehicle.
+//
+// Returns the number of events processed.
+unsigned long runEventLoop(vector<shared_ptr<Vehicle>>& vehicles, ChargingStation& chargingStation, double runTime);
+
+#endif //_EVENT_SIMULATION_H
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+#include "./Checkpoint.h"
+#include "./FleetChargingStation.h"
+
+// Constructor
+FleetChargingStation::FleetChargingStation(unsigned int numberOfChargingSlots, bool byNeed,
+                                           size_t fleetSize) :
+        cNumberOfChargingSlots(numberOfChargingSlots),
+        cByNeed(byNeed),
+        chargers(numberOfChargingSlots),
+        numberCharging(0),
+        queueHead(0),
+        queueTail(0),
+        numberWaiting(0),
+        arrivals(0)
+{
+    // Every vehicle of the fleet can end up in the one queue
+    if (cByNeed) {
+        needQueue.reserve(fleetSize);
+    }
+}
+
+bool FleetChargingStation::lessNeedy(const NeedEntry& a, const NeedEntry& b) {
+    // std heaps keep the greatest element in front
+    return a.stateOfCharge > b.stateOfCharge || (a.stateOfCharge == b.stateOfCharge && a.arrival > b.arrival);
+}
+
+// Add a vehicle to the back of the waitQueue
+void FleetChargingStation::addVehicle(FleetState& fleet, VehicleIndex vehicle) {
+    if (cByNeed) {
+        assert(needQueue.size() < needQueue.capacity());
+        needQueue.push_back({fleet.getStateOfCharge(vehicle), arrivals++, vehicle});
+        std::push_heap(needQueue.begin(), needQueue.end(), lessNeedy);
+    } else if (numberWaiting == 0) {
+        queueHead = vehicle;
+    } else {
+        fleet.setQueueNext(queueTail, vehicle);
+    }
+    queueTail = vehicle;
+    ++numberWaiting;
+    fleet.setInWaitQueue(vehicle);
+}
+
+// Process the charge slots and wait queue
+void FleetChargingStation::iterate(FleetState& fleet) {
+    // Check who's done charging and remove them
+    for (unsigned int slot = 0; slot < numberCharging;) {
+        if (!fleet.isCharging(chargers[slot])) {
+            chargers[slot] = chargers[--numberCharging]; // No longer charging so remove from charging station
+        } else {
+            ++slot;
+        }
+    }
+
+    // Add vehicles to the charger if possible
+    while (numberWaiting > 0 && numberCharging < cNumberOfChargingSlots) {
+        VehicleIndex v;
+        if (cByNeed) {
+            std::pop_heap(needQueue.begin(), needQueue.end(), lessNeedy);
+            v = needQueue.back().vehicle;
+            needQueue.pop_back();
+        } else {
+            v = queueHead;
+            queueHead = fleet.getQueueNext(v);
+        }
+        --numberWaiting;
+        chargers[numberCharging++] = v;
+        fleet.setCharging(v);
+    }
+}
+
+void FleetChargingStation::reset() {
+    numberWaiting = 0;
+    numberCharging = 0;
+    needQueue.clear();
+    arrivals = 0;
+}
+
+void FleetChargingStation::save(CheckpointWriter& writer) const {
+    writer.write(static_cast<uint32_t>(cNumberOfChargingSlots));
+    writer.write(static_cast<uint32_t>(numberCharging));
+    writer.write(chargers.data(), numberCharging * sizeof(VehicleIndex));
+    writer.write(queueHead);
+    writer.write(queueTail);
+    writer.write(static_cast<uint64_t>(numberWaiting));
+    writer.write(static_cast<uint8_t>(cByNeed));
+    writer.writeArray(needQueue);
+    writer.write(arrivals);
+}
+
+size_t FleetChargingStation::memoryUsage() const {
+    return sizeof(FleetChargingStation) + chargers.capacity() * sizeof(VehicleIndex) +
+           needQueue.capacity() * sizeof(NeedEntry);
+}
+
+bool FleetChargingStation::restore(CheckpointReader& reader, size_t fleetSize) {
+    uint32_t slots = 0;
+    uint32_t charging = 0;
+    uint64_t waiting = 0;
+    if (reader.read(slots) && slots != cNumberOfChargingSlots) {
+        return reader.fail("checkpoint has " + std::to_string(slots) + " charging slots per station, the scenario has " +
+                           std::to_string(cNumberOfChargingSlots));
+    }
+    if (reader.read(charging) && charging > cNumberOfChargingSlots) {
+        return reader.fail("bad checkpoint station");
+    }
+    reader.read(chargers.data(), charging * sizeof(VehicleIndex));
+    reader.read(queueHead);
+    reader.read(queueTail);
+    reader.read(waiting);
+    uint8_t byNeed = 0;
+    if (reader.read(byNeed) && (byNeed != 0) != cByNeed) {
+        return reader.fail("checkpoint charge queue order doesn't match the scenario");
+    }
+    reader.readArray(needQueue);
+    reader.read(arrivals);
+    if (!reader.ok()) {
+        reset();
+        return false;
+    }
+
+    numberCharging = charging;
+    numberWaiting = static_cast<size_t>(waiting);
+    for (unsigned int slot = 0; slot < numberCharging; ++slot) {
+        if (chargers[slot] >= fleetSize) {
+            reset();
+            return reader.fail("bad checkpoint station");
+        }
+    }
+    if (!cByNeed && numberWaiting > 0 && (queueHead >= fleetSize || queueTail >= fleetSize)) {
+        reset();
+        return reader.fail("bad checkpoint station");
+    }
+    bool needQueueConsistent = cByNeed ? needQueue.size() == numberWaiting && numberWaiting <= fleetSize
+                                       : needQueue.empty();
+    for (const NeedEntry& entry : needQueue) {
+        needQueueConsistent = needQueueConsistent && entry.vehicle < fleetSize;
+    }
+    if (!needQueueConsistent) {
+        reset();
+        return reader.fail("bad checkpoint station");
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef _FLEET_CHARGING_STATION_H
+#define _FLEET_CHARGING_STATION_H
+
+#include <cstdint>
+#include <vector>
+
+#include "./FleetState.h"
+
+// ChargingStation for a FleetState - same charging and queueing rules, but vehicles are
+// referred to by their index in the fleet instead of through IChargeable.
+//
+// The charging slots are allocated on construction and the wait queue is threaded through the
+// fleet's per vehicle queue links (see FleetState::getQueueNext()), so nothing is allocated while
+// the simulation runs and a network of stations needs no per station queue storage.
+//
+// A station can instead serve its queue by charge need, lowest state of charge first and first come
+// first served on ties, for fleets with the battery model (see FleetState::enableBattery()). That queue
+// is a binary heap, O(log n) to add or take a vehicle, with room for the whole fleet allocated on
+// construction (24 bytes a vehicle for each station).
+class FleetChargingStation {
+private:
+    // A vehicle waiting in the charge need queue
+    struct NeedEntry {
+        double stateOfCharge;   // When it joined the queue, a waiting vehicle's charge doesn't change
+        uint64_t arrival;       // Order it joined the queue in, breaks ties
+        VehicleIndex vehicle;
+    };
+
+    // Heap order, puts the most needy vehicle at the front
+    static bool lessNeedy(const NeedEntry& a, const NeedEntry& b);
+
+    const unsigned int cNumberOfChargingSlots;
+    const bool cByNeed;
+
+    std::vector<VehicleIndex> chargers;  // cNumberOfChargingSlots slots, the first numberCharging are in use
+    unsigned int numberCharging;
+
+    // FIFO wait queue, linked through the fleet
+    VehicleIndex queueHead;
+    VehicleIndex queueTail;
+    size_t numberWaiting;
+
+    // Charge need wait queue, only used when serving by need
+    std::vector<NeedEntry> needQueue;
+    uint64_t arrivals;
+
+public:
+    // Initialization state is the number of charging slots, and whether the queue is served by charge
+    // need rather than in arrival order for a fleet of up to fleetSize vehicles
+    explicit FleetChargingStation(unsigned int numberOfChargingSlots, bool byNeed = false,
+                                  size_t fleetSize = 0);
+
+    // Disable unneeded defaults
+    FleetChargingStation(const FleetChargingStation&) = delete;
+    FleetChargingStation& operator=(const FleetChargingStation&) = delete;
+
+    // Add a vehicle to the wait queue
+    void addVehicle(FleetState& fleet, VehicleIndex vehicle);
+
+    // Iterate manages the charging slots and wait queue
+    void iterate(FleetState& fleet);
+
+    // Empty the charging slots and wait queue
+    void reset();
+
+    // Write the charging slots and wait queue to a checkpoint, the FIFO queue links are saved with the fleet
+    void save(CheckpointWriter& writer) const;
+
+    // Read back what save() wrote, for a fleet of fleetSize vehicles. Returns false with the reason in the
+    // reader if the number of slots or the queue order doesn't match.
+    bool restore(CheckpointReader& reader, size_t fleetSize);
+
+    unsigned int getNumberCharging() const { return numberCharging; }
+    size_t getNumberWaiting() const { return numberWaiting; }
+
+    // Bytes allocated for the station
+    size_t memoryUsage() const;
+};
+
+#endif //_FLEET_CHARGING_STATION_H
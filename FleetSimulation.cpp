@@ -0,0 +1,109 @@
+#include <cassert>
+#include <iostream>
+
+#include "./FleetSimulation.h"
+#include "./Profiler.h"
+#include "./Simulation.h"
+
+namespace {
+
+void saveRunCheckpoint(const std::string& path, const FleetClock& clock, const FleetState& fleet,
+                       const StationNetwork& stations) {
+    std::string error;
+    if (!saveCheckpoint(path, clock, fleet, stations, error)) {
+        std::cerr << error << std::endl;
+    }
+}
+
+}
+
+void stepFleet(FleetState& fleet, StationNetwork& stations, double increment, ThreadPool& pool,
+               vector<VehicleIndex>& landed, vector<VehicleIndex>& charged) {
+    // Iterate the whole fleet, then free the slots of the vehicles that finished charging and
+    // route the vehicles that landed to a station
+    PROFILE_PHASE(simulation_pass);
+    landed.clear();
+    charged.clear();
+    {
+        PROFILE_PHASE(vehicle_iteration);
+        fleet.iterate(increment, landed, charged, pool);
+    }
+    if (!landed.empty() || !charged.empty()) {
+        PROFILE_PHASE(station_handoff);
+        for (VehicleIndex v : charged) {
+            stations.chargeComplete(v);
+        }
+        for (VehicleIndex v : landed) {
+            stations.addVehicle(fleet, v);
+        }
+    }
+
+    {
+        PROFILE_PHASE(station_iteration);
+        stations.iterate(fleet);
+    }
+}
+
+unsigned long runFleetLoop(FleetState& fleet, StationNetwork& stations,
+                           Pacer* pacer, double increment, double runTime, ThreadPool& pool,
+                           Telemetry* telemetry, const FleetCheckpoint* checkpoint, FleetDemand* demand,
+                           LiveExport* live) {
+    assert(!demand || fleet.hasDemand());
+    double currentTime = checkpoint ? checkpoint->start.currentTime : 0.0;
+    bool saveCheckpointDue = checkpoint && !checkpoint->savePath.empty();
+    if (pacer) {
+        pacer->start();
+    }
+
+    // Vehicles that finished their flight or their charge on the current pass, these grow to the
+    // busiest pass rather than being reserved for the whole fleet
+    vector<VehicleIndex> landed;
+    vector<VehicleIndex> charged;
+
+    unsigned long totalIterations = checkpoint ? checkpoint->start.totalIterations : 0;
+    while (currentTime < runTime) {
+        if (pacer) {
+            // Sleep until the next tick is due, the increment covers every tick due so far
+            increment = pacer->next();
+        }
+
+        if (telemetry && telemetry->isDue(currentTime)) {
+            PROFILE_PHASE(telemetry_sample);
+            telemetry->record(currentTime, fleet, stations);
+        }
+        if (live && live->isDue(currentTime)) {
+            PROFILE_PHASE(live_publish);
+            live->publish(currentTime, fleet, stations);
+        }
+
+        if (saveCheckpointDue && currentTime >= checkpoint->saveTime) {
+            saveRunCheckpoint(checkpoint->savePath, FleetClock{currentTime, totalIterations}, fleet, stations);
+            saveCheckpointDue = false;
+        }
+
+        if (demand) {
+            PROFILE_PHASE(demand_dispatch);
+            demand->dispatch(currentTime, fleet);
+        }
+
+        stepFleet(fleet, stations, increment, pool, landed, charged);
+
+        // Fixed steps work the time out from the number of passes, same as runTickLoop()
+        ++totalIterations;
+        currentTime = pacer ? currentTime + increment : static_cast<double>(totalIterations) * increment;
+    }
+    if (telemetry) {
+        telemetry->record(currentTime, fleet, stations);
+    }
+    if (live) {
+        live->publish(currentTime, fleet, stations);
+    }
+    // A checkpoint at the end of the run, so it can be carried on with a longer duration
+    if (saveCheckpointDue && currentTime >= checkpoint->saveTime) {
+        saveRunCheckpoint(checkpoint->savePath, FleetClock{currentTime, totalIterations}, fleet, stations);
+    }
+
+    // Model totals are only gathered at the end of the run
+    fleet.accumulateModelTotals(pool);
+    return totalIterations;
+}
@@ -0,0 +1,46 @@
+#ifndef _FLEET_SIMULATION_H
+#define _FLEET_SIMULATION_H
+
+#include <string>
+
+#include "./Checkpoint.h"
+#include "./Demand.h"
+#include "./FleetState.h"
+#include "./LiveExport.h"
+#include "./Pacer.h"
+#include "./StationNetwork.h"
+#include "./Telemetry.h"
+#include "./ThreadPool.h"
+
+// Checkpointing of a runFleetLoop() run (see Checkpoint.h)
+struct FleetCheckpoint {
+    FleetClock start;       // {0, 0} for a new run, or the clock of a restored checkpoint
+    std::string savePath;   // Checkpoint to write, empty for none
+    double saveTime;        // World time minutes to write it at, the run carries on afterwards
+};
+
+// One pass of runFleetLoop(). landed and charged are scratch space for the vehicles that change state,
+// keep them from one pass to the next so passes stop allocating once they have grown to fit.
+void stepFleet(FleetState& fleet, StationNetwork& stations, double increment, ThreadPool& pool,
+               vector<VehicleIndex>& landed, vector<VehicleIndex>& charged);
+
+// The fixed increment simulation loop over a FleetState, returns the number of passes made over the fleet.
+// Same parameters as runTickLoop(), with a network of charging stations. The fleet is stepped across the
+// pool, the hand off to the stations stays on the calling thread. Vehicles that land on the same pass are
+// handed to the network in index order rather than in a shuffled order, so results don't depend on the
+// pool size.
+//
+// With a checkpoint the run continues from its start clock up to runTime, and the returned number of
+// passes includes the ones made before the start. The checkpoint is saved before the first pass at or
+// after its saveTime, an error saving it is reported on cerr and the run carries on.
+//
+// With demand the fleet must have been built with FleetState::enableDemand(), the requests that have
+// arrived wake parked vehicles at the start of each pass.
+//
+// A live export is published whenever it is due and once at the end of the run, same as telemetry.
+unsigned long runFleetLoop(FleetState& fleet, StationNetwork& stations,
+                           Pacer* pacer, double increment, double runTime, ThreadPool& pool,
+                           Telemetry* telemetry = nullptr, const FleetCheckpoint* checkpoint = nullptr,
+                           FleetDemand* demand = nullptr, LiveExport* live = nullptr);
+
+#endif //_FLEET_SIMULATION_H
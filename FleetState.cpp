@@ -0,0 +1,862 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "./Checkpoint.h"
+#include "./FleetState.h"
+#include "./Profiler.h"
+#include "./RandomStream.h"
+
+using std::cout;
+
+namespace {
+
+// Keeps the trip draws apart from the fault draws when both have the same seed
+const uint64_t cTripDraws = 0x5851F42D4C957F2DULL;
+// And the trip destination and starting vertiport draws from both
+const uint64_t cVertiportDraws = 0x2545F4914F6CDD1DULL;
+const uint64_t cStartDraws = 0x9FB21C651E98DF25ULL;
+
+}
+
+FleetState::FleetState(const vector<shared_ptr<ModelData>>& models) :
+        models(models),
+        modelMeanTimeBetweenFaults(models.size(), std::numeric_limits<double>::infinity()),
+        faults(false),
+        faultSeed(0),
+        maintenanceTime(0.0),
+        battery(false),
+        tripSeed(0),
+        minimumTripTime(std::numeric_limits<double>::infinity()),
+        maximumTripTime(std::numeric_limits<double>::infinity()),
+        chargeTo(1.0),
+        vehicleTotals(true),
+        demand(false),
+        sessions(nullptr)
+{
+    assert(models.size() <= cMaxModels);
+    for (const shared_ptr<ModelData>& model : models) {
+        modelEndurance.push_back(model->params.endurance);
+        modelTimeToCharge.push_back(model->params.timeToCharge);
+    }
+}
+
+void FleetState::enableFaults(unsigned long seed, double maintenanceTime) {
+    assert(size() == 0);
+    faults = true;
+    faultSeed = seed;
+    this->maintenanceTime = maintenanceTime;
+    for (size_t m = 0; m < models.size(); ++m) {
+        double faultsPerHour = models[m]->params.MaxFaultsPerHour;
+        modelMeanTimeBetweenFaults[m] = faultsPerHour > 0.0 ? 60.0 / faultsPerHour
+                                                            : std::numeric_limits<double>::infinity();
+    }
+}
+
+void FleetState::enableBattery(unsigned long seed, double minimumTripTime, double maximumTripTime,
+                               double chargeTo) {
+    assert(size() == 0);
+    assert(minimumTripTime <= maximumTripTime && chargeTo > 0.0 && chargeTo <= 1.0);
+    battery = true;
+    tripSeed = seed;
+    this->minimumTripTime = minimumTripTime;
+    this->maximumTripTime = maximumTripTime;
+    this->chargeTo = chargeTo;
+}
+
+void FleetState::enableVertiports(shared_ptr<const VertiportMap> map) {
+    assert(size() == 0 && battery && map && map->size() >= 2);
+    vertiports = map;
+    modelMinutesPerMile.clear();
+    for (const shared_ptr<ModelData>& model : models) {
+        modelMinutesPerMile.push_back(60.0 / model->params.cruiseSpeed);
+    }
+}
+
+void FleetState::keepVehicleTotals(bool keep) {
+    assert(size() == 0);
+    vehicleTotals = keep;
+}
+
+void FleetState::enableDemand() {
+    assert(size() == 0);
+    demand = true;
+}
+
+void FleetState::recordSessions(SessionStatistics* statistics) {
+    assert(!statistics || statistics->numberOfModels() == models.size());
+    sessions = statistics;
+}
+
+void FleetState::reserve(size_t fleetSize) {
+    operationState.reserve(fleetSize);
+    modelIndex.reserve(fleetSize);
+    currentOperationTime.reserve(fleetSize);
+    operationLength.reserve(fleetSize);
+    queueNext.reserve(fleetSize);
+    if (faults) {
+        flightUntilFault.reserve(fleetSize);
+        faultCount.reserve(fleetSize);
+    }
+    if (battery) {
+        stateOfCharge.reserve(fleetSize);
+        tripCount.reserve(fleetSize);
+    }
+    if (vertiports) {
+        vertiport.reserve(fleetSize);
+    }
+    if (vehicleTotals) {
+        totalTimeEnRoute.reserve(fleetSize);
+        totalTimeCharging.reserve(fleetSize);
+        totalTimeWaiting.reserve(fleetSize);
+        totalTimeGrounded.reserve(fleetSize);
+    }
+    if (demand) {
+        blockActive.reserve((fleetSize + cBlockSize - 1) / cBlockSize);
+        parkedHeap.reserve(fleetSize);
+    }
+    chunkTotals.reserve((fleetSize + cChunkSize - 1) / cChunkSize * models.size());
+}
+
+void FleetState::clear() {
+    operationState.clear();
+    modelIndex.clear();
+    currentOperationTime.clear();
+    operationLength.clear();
+    queueNext.clear();
+    flightUntilFault.clear();
+    faultCount.clear();
+    stateOfCharge.clear();
+    tripCount.clear();
+    vertiport.clear();
+    totalTimeEnRoute.clear();
+    totalTimeCharging.clear();
+    totalTimeWaiting.clear();
+    totalTimeGrounded.clear();
+    blockActive.clear();
+    parkedHeap.clear();
+    chunkTotals.clear();
+}
+
+VehicleIndex FleetState::addVehicle(ModelIndex model) {
+    assert(model < models.size());
+    VehicleIndex vehicle = static_cast<VehicleIndex>(size());
+    operationState.push_back(OperationState::en_route);
+    modelIndex.push_back(static_cast<FleetModelIndex>(model));
+    currentOperationTime.push_back(0.0);
+    operationLength.push_back(modelEndurance[model]);
+    queueNext.push_back(0);
+    if (faults) {
+        flightUntilFault.push_back(drawFlightUntilFault(vehicle, model, 0));
+        faultCount.push_back(0);
+    }
+    if (battery) {
+        stateOfCharge.push_back(1.0);
+        tripCount.push_back(0);
+    }
+    if (vertiports) {
+        double draw = uniformDraw(tripSeed ^ cStartDraws, vehicle, 0);
+        vertiport.push_back(static_cast<VertiportIndex>(std::min(draw * static_cast<double>(vertiports->size()),
+                                                                 static_cast<double>(vertiports->size() - 1))));
+    }
+    if (faults || battery) {
+        operationLength[vehicle] = flightLength(vehicle);
+    }
+    if (vehicleTotals) {
+        totalTimeEnRoute.push_back(0.0);
+        totalTimeCharging.push_back(0.0);
+        totalTimeWaiting.push_back(0.0);
+        totalTimeGrounded.push_back(0.0);
+    }
+    if (vehicle % cChunkSize == 0) {
+        chunkTotals.resize(chunkTotals.size() + models.size(), ModelTotals{});
+    }
+    if (demand) {
+        // Indices only grow, so the heap stays a heap without sifting
+        operationState[vehicle] = OperationState::parked;
+        parkedHeap.push_back(vehicle);
+        if (vehicle % cBlockSize == 0) {
+            blockActive.push_back(0);
+        }
+    }
+    ++(models[model]->fleetCount);
+    return vehicle;
+}
+
+size_t FleetState::size() const {
+    return operationState.size();
+}
+
+size_t FleetState::numberOfChunks() const {
+    return (size() + cChunkSize - 1) / cChunkSize;
+}
+
+namespace {
+
+// The per step update of Vehicle::iterate() without the switch. Only the operation time is advanced
+// (in the queue states too, where it measures the wait); timed operations that complete are flagged and
+// left for the scalar pass in FleetState::iterate(), which also settles the totals. 0.0/1.0 masks keep
+// the loop free of branches so it vectorizes (check with -fopt-info-vec).
+// Returns the number of flagged vehicles.
+unsigned int iterateKernel(size_t n, double deltaT,
+                           uint8_t* __restrict state, double* __restrict opTime, const double* __restrict opLength) {
+    unsigned int transitions = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t s = state[i];
+        const double flying = s == OperationState::en_route;
+        const double charging = s == OperationState::charging;
+        const double grounded = s == OperationState::grounded;
+        const double timed = flying + charging + grounded;
+
+        const double newOperationTime = opTime[i] + deltaT;
+        const double done = timed * (newOperationTime + cOperationTimeTolerance >= opLength[i]);
+
+        // Completed operations keep their last time so the scalar pass can work out the overrun
+        opTime[i] = newOperationTime * (1.0 - done) + opTime[i] * done;
+
+        const uint8_t changed = done != 0.0;
+        state[i] = static_cast<uint8_t>(s + changed * FleetState::cTransitionFlag);
+        transitions += changed;
+    }
+    return transitions;
+}
+
+}
+
+unsigned int FleetState::iterateBlock(size_t begin, size_t end, double deltaT) {
+    return iterateKernel(end - begin, deltaT,
+                         &operationState[begin], &currentOperationTime[begin], &operationLength[begin]);
+}
+
+void FleetState::iterate(double deltaT, vector<VehicleIndex>& landed) {
+    parked.clear();
+    chargeSessions.clear();
+    iterateRange(0, size(), deltaT, landed, nullptr, parked, chargeSessions);
+    addParked(parked);
+    addChargeSessions(chargeSessions);
+}
+
+void FleetState::iterate(double deltaT, vector<VehicleIndex>& landed, ThreadPool& pool) {
+    iterateChunks(deltaT, landed, nullptr, pool);
+}
+
+void FleetState::iterate(double deltaT, vector<VehicleIndex>& landed, vector<VehicleIndex>& charged) {
+    parked.clear();
+    chargeSessions.clear();
+    iterateRange(0, size(), deltaT, landed, &charged, parked, chargeSessions);
+    addParked(parked);
+    addChargeSessions(chargeSessions);
+}
+
+void FleetState::iterate(double deltaT, vector<VehicleIndex>& landed, vector<VehicleIndex>& charged,
+                         ThreadPool& pool) {
+    iterateChunks(deltaT, landed, &charged, pool);
+}
+
+void FleetState::iterateChunks(double deltaT, vector<VehicleIndex>& landed, vector<VehicleIndex>* charged,
+                               ThreadPool& pool) {
+    const size_t chunks = numberOfChunks();
+    if (chunkLanded.size() < chunks) {
+        chunkLanded.resize(chunks);
+        chunkCharged.resize(chunks);
+        chunkParked.resize(chunks);
+        chunkChargeSessions.resize(chunks);
+    }
+
+    pool.run(chunks, [&](size_t chunk) {
+        chunkLanded[chunk].clear();
+        chunkCharged[chunk].clear();
+        chunkParked[chunk].clear();
+        chunkChargeSessions[chunk].clear();
+        iterateRange(chunk * cChunkSize, std::min((chunk + 1) * cChunkSize, size()), deltaT, chunkLanded[chunk],
+                     charged ? &chunkCharged[chunk] : nullptr, chunkParked[chunk], chunkChargeSessions[chunk]);
+    });
+
+    // Chunks are in index order
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        landed.insert(landed.end(), chunkLanded[chunk].begin(), chunkLanded[chunk].end());
+        if (charged) {
+            charged->insert(charged->end(), chunkCharged[chunk].begin(), chunkCharged[chunk].end());
+        }
+        addParked(chunkParked[chunk]);
+        addChargeSessions(chunkChargeSessions[chunk]);
+    }
+}
+
+void FleetState::iterateRange(size_t rangeBegin, size_t rangeEnd, double deltaT, vector<VehicleIndex>& landed,
+                              vector<VehicleIndex>* charged, vector<VehicleIndex>& parked,
+                              vector<ChargeSession>& chargeSessions) {
+    for (size_t begin = rangeBegin; begin < rangeEnd; begin += cBlockSize) {
+        size_t end = std::min(begin + cBlockSize, rangeEnd);
+        // Parked vehicles have nothing to update, their operation time starts again when they are woken
+        if (demand && blockActive[begin / cBlockSize] == 0) {
+            continue;
+        }
+        if (iterateBlock(begin, end, deltaT) == 0) {
+            continue;
+        }
+
+        // Scalar pass over the (rare) blocks with state changes
+        for (size_t i = begin; i < end; ++i) {
+            if ((operationState[i] & cTransitionFlag) == 0) {
+                continue;
+            }
+            operationState[i] &= ~cTransitionFlag;
+#ifdef JOBY_PROFILE
+            const uint8_t previousState = operationState[i];
+#endif
+
+            // Same as Vehicle::iterate() the step that completes an operation isn't counted in the
+            // totals and the overrun carries over to the next mode
+            double overrun = std::max(currentOperationTime[i] + deltaT - operationLength[i], 0.0);
+            addTime(i, operationState[i], currentOperationTime[i]);
+            if (operationState[i] == OperationState::en_route) {
+                if (battery) {
+                    stateOfCharge[i] -= operationLength[i] / modelEndurance[modelIndex[i]];
+                }
+                if (faults && flightUntilFault[i] <= operationLength[i]) {
+                    // The flight was cut short by a fault
+                    ++faultCount[i];
+                    ++chunkTotals[(i / cChunkSize) * models.size() + modelIndex[i]].totalFaults;
+                    operationState[i] = OperationState::grounded;
+                    operationLength[i] = maintenanceTime;
+                    flightUntilFault[i] = drawFlightUntilFault(static_cast<VehicleIndex>(i), modelIndex[i],
+                                                               faultCount[i]);
+                } else {
+                    if (faults) {
+                        flightUntilFault[i] -= operationLength[i];
+                    }
+                    if (vertiports) {
+                        vertiport[i] = tripDestination(static_cast<VehicleIndex>(i));
+                    }
+                    if (battery) {
+                        ++tripCount[i];
+                    }
+                    const double nextTrip = battery ? tripTime(static_cast<VehicleIndex>(i))
+                                                    : std::numeric_limits<double>::infinity();
+                    if (!std::isinf(nextTrip) &&
+                        stateOfCharge[i] * modelEndurance[modelIndex[i]] + cOperationTimeTolerance >= nextTrip) {
+                        // Enough charge left for the next trip, straight back in the air or parked until
+                        // it is asked for
+                        if (demand) {
+                            park(i);
+                            parked.push_back(static_cast<VehicleIndex>(i));
+                        } else {
+                            operationLength[i] = flightLength(static_cast<VehicleIndex>(i));
+                        }
+                    } else {
+                        operationState[i] = OperationState::waiting_for_charge_queue;
+                        landed.push_back(static_cast<VehicleIndex>(i));
+                    }
+                }
+            } else if (operationState[i] == OperationState::charging) {
+                if (sessions) {
+                    chargeSessions.push_back(ChargeSession{modelIndex[i], operationLength[i]});
+                }
+                // Done charging and back in the air, or parked until a trip is asked for
+                if (battery) {
+                    stateOfCharge[i] = chargeTarget(static_cast<VehicleIndex>(i));
+                }
+                if (demand) {
+                    park(i);
+                    parked.push_back(static_cast<VehicleIndex>(i));
+                } else {
+                    operationState[i] = OperationState::en_route;
+                    operationLength[i] = flightLength(static_cast<VehicleIndex>(i));
+                }
+                if (charged) {
+                    charged->push_back(static_cast<VehicleIndex>(i));
+                }
+            } else {
+                // Maintained, recharged and back in the air on a new trip (or parked)
+                if (battery) {
+                    stateOfCharge[i] = 1.0;
+                    ++tripCount[i];
+                }
+                if (demand) {
+                    park(i);
+                    parked.push_back(static_cast<VehicleIndex>(i));
+                } else {
+                    operationState[i] = OperationState::en_route;
+                    operationLength[i] = flightLength(static_cast<VehicleIndex>(i));
+                }
+            }
+            currentOperationTime[i] = overrun;
+            addTime(i, operationState[i], -overrun);
+            PROFILE_TRANSITION(models[modelIndex[i]].get(), previousState, operationState[i]);
+        }
+    }
+}
+
+void FleetState::park(size_t vehicle) {
+    // The overrun is dropped with the rest of the parked time, parked vehicles aren't timed
+    operationState[vehicle] = OperationState::parked;
+    operationLength[vehicle] = 0.0;
+    --blockActive[vehicle / cBlockSize];
+}
+
+void FleetState::addChargeSessions(const vector<ChargeSession>& ended) {
+    if (!sessions) {
+        return;
+    }
+    for (const ChargeSession& session : ended) {
+        sessions->recordCharge(session.model, session.length);
+    }
+}
+
+void FleetState::addParked(const vector<VehicleIndex>& vehicles) {
+    for (VehicleIndex vehicle : vehicles) {
+        parkedHeap.push_back(vehicle);
+        std::push_heap(parkedHeap.begin(), parkedHeap.end(), std::greater<VehicleIndex>());
+    }
+}
+
+VehicleIndex FleetState::wake() {
+    assert(!parkedHeap.empty());
+    std::pop_heap(parkedHeap.begin(), parkedHeap.end(), std::greater<VehicleIndex>());
+    VehicleIndex vehicle = parkedHeap.back();
+    parkedHeap.pop_back();
+
+    PROFILE_TRANSITION(models[modelIndex[vehicle]].get(), OperationState::parked, OperationState::en_route);
+    operationState[vehicle] = OperationState::en_route;
+    currentOperationTime[vehicle] = 0.0;
+    operationLength[vehicle] = flightLength(vehicle);
+    ++blockActive[vehicle / cBlockSize];
+    return vehicle;
+}
+
+void FleetState::addTime(size_t vehicle, uint8_t state, double time) {
+    ModelTotals& totals = chunkTotals[(vehicle / cChunkSize) * models.size() + modelIndex[vehicle]];
+    switch (state) {
+        case OperationState::en_route:
+            totals.totalFlightTime += time;
+            if (vehicleTotals) {
+                totalTimeEnRoute[vehicle] += time;
+            }
+            break;
+        case OperationState::charging:
+            totals.totalChargingTime += time;
+            if (vehicleTotals) {
+                totalTimeCharging[vehicle] += time;
+            }
+            break;
+        case OperationState::in_charge_queue:
+            totals.totalWaitingTime += time;
+            if (vehicleTotals) {
+                totalTimeWaiting[vehicle] += time;
+            }
+            break;
+        case OperationState::grounded:
+            totals.totalGroundedTime += time;
+            if (vehicleTotals) {
+                totalTimeGrounded[vehicle] += time;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void FleetState::setCharging(VehicleIndex vehicle) {
+    PROFILE_TRANSITION(models[modelIndex[vehicle]].get(), operationState[vehicle], OperationState::charging);
+    // Settle the time spent in the queue, charging starts from 0
+    addTime(vehicle, operationState[vehicle], currentOperationTime[vehicle]);
+    if (sessions) {
+        sessions->recordWait(modelIndex[vehicle], currentOperationTime[vehicle] - operationLength[vehicle]);
+    }
+    operationState[vehicle] = OperationState::charging;
+    currentOperationTime[vehicle] = 0;
+    operationLength[vehicle] = modelTimeToCharge[modelIndex[vehicle]];
+    if (battery) {
+        // Only as far as the charge target
+        operationLength[vehicle] *= std::max(chargeTarget(vehicle) - stateOfCharge[vehicle], 0.0);
+    }
+}
+
+bool FleetState::isCharging(VehicleIndex vehicle) const {
+    return operationState[vehicle] == OperationState::charging;
+}
+
+void FleetState::setInWaitQueue(VehicleIndex vehicle) {
+    PROFILE_TRANSITION(models[modelIndex[vehicle]].get(), operationState[vehicle], OperationState::in_charge_queue);
+    operationState[vehicle] = OperationState::in_charge_queue;
+    // The wait is the operation time gained until charging starts. The queue has no length, so the
+    // operation time the wait started at is kept there for setCharging().
+    addTime(vehicle, OperationState::in_charge_queue, -currentOperationTime[vehicle]);
+    operationLength[vehicle] = currentOperationTime[vehicle];
+}
+
+bool FleetState::isWaitingForQueue(VehicleIndex vehicle) const {
+    return operationState[vehicle] == OperationState::waiting_for_charge_queue;
+}
+
+OperationState FleetState::getOpState(VehicleIndex vehicle) const {
+    return static_cast<OperationState>(operationState[vehicle]);
+}
+
+ModelIndex FleetState::getModel(VehicleIndex vehicle) const {
+    return modelIndex[vehicle];
+}
+
+double FleetState::inProgress(VehicleIndex vehicle, OperationState state) const {
+    if (operationState[vehicle] != state) {
+        return 0.0;
+    }
+    return currentOperationTime[vehicle];
+}
+
+double FleetState::getTotalTimeEnRoute(VehicleIndex vehicle) const {
+    assert(vehicleTotals);
+    return totalTimeEnRoute[vehicle] + inProgress(vehicle, OperationState::en_route);
+}
+
+double FleetState::getTotalTimeCharging(VehicleIndex vehicle) const {
+    assert(vehicleTotals);
+    return totalTimeCharging[vehicle] + inProgress(vehicle, OperationState::charging);
+}
+
+double FleetState::getTotalTimeWaiting(VehicleIndex vehicle) const {
+    assert(vehicleTotals);
+    return totalTimeWaiting[vehicle] + inProgress(vehicle, OperationState::in_charge_queue);
+}
+
+double FleetState::getTotalTimeGrounded(VehicleIndex vehicle) const {
+    assert(vehicleTotals);
+    return totalTimeGrounded[vehicle] + inProgress(vehicle, OperationState::grounded);
+}
+
+uint32_t FleetState::getFaultCount(VehicleIndex vehicle) const {
+    return faults ? faultCount[vehicle] : 0;
+}
+
+void FleetState::setVertiport(VehicleIndex vehicle, VertiportIndex at) {
+    assert(vertiports && at < vertiports->size());
+    vertiport[vehicle] = at;
+}
+
+double FleetState::getStateOfCharge(VehicleIndex vehicle) const {
+    assert(battery);
+    const ModelIndex model = modelIndex[vehicle];
+    return stateOfCharge[vehicle] - inProgress(vehicle, OperationState::en_route) / modelEndurance[model] +
+           inProgress(vehicle, OperationState::charging) / modelTimeToCharge[model];
+}
+
+double FleetState::drawFlightUntilFault(VehicleIndex vehicle, ModelIndex model, uint32_t faultNumber) const {
+    const double mean = modelMeanTimeBetweenFaults[model];
+    if (std::isinf(mean)) {
+        return mean;
+    }
+    // Exponential inter-arrival time
+    return -std::log1p(-uniformDraw(faultSeed, vehicle, faultNumber)) * mean;
+}
+
+VertiportIndex FleetState::tripDestination(VehicleIndex vehicle) const {
+    return vertiports->destination(vertiport[vehicle],
+                                   uniformDraw(tripSeed ^ cVertiportDraws, vehicle, tripCount[vehicle]));
+}
+
+double FleetState::tripTime(VehicleIndex vehicle) const {
+    if (vertiports) {
+        const VertiportIndex from = vertiport[vehicle];
+        return distance(vertiports->position(from), vertiports->position(tripDestination(vehicle))) *
+               modelMinutesPerMile[modelIndex[vehicle]];
+    }
+    if (std::isinf(maximumTripTime)) {
+        return maximumTripTime;
+    }
+    return minimumTripTime +
+           uniformDraw(tripSeed ^ cTripDraws, vehicle, tripCount[vehicle]) * (maximumTripTime - minimumTripTime);
+}
+
+double FleetState::chargeTarget(VehicleIndex vehicle) const {
+    const double nextTrip = tripTime(vehicle);
+    if (std::isinf(nextTrip)) {
+        return chargeTo;
+    }
+    // A trip longer than a full battery is flown as far as the battery goes
+    return std::max(chargeTo, std::min(nextTrip / modelEndurance[modelIndex[vehicle]], 1.0));
+}
+
+double FleetState::flightLength(VehicleIndex vehicle) const {
+    const double endurance = modelEndurance[modelIndex[vehicle]];
+    double length = endurance;
+    if (battery) {
+        length = std::min(tripTime(vehicle), stateOfCharge[vehicle] * endurance);
+    }
+    return faults ? std::min(length, flightUntilFault[vehicle]) : length;
+}
+
+void FleetState::sample(vector<uint64_t>& stateCounts, vector<ModelTotals>& modelTotals) const {
+    // Vehicles are spread over cLanes sets of counters so consecutive vehicles of the same model don't
+    // wait on each other's adds, the lanes are combined at the end
+    const size_t cLanes = 4;
+    uint64_t laneCounts[cLanes][cNumberOfOperationStates] = {};
+    vector<ModelTotals> laneTotals(cLanes * models.size(), ModelTotals{});
+
+    for (VehicleIndex i = 0; i < size(); ++i) {
+        const size_t lane = i % cLanes;
+        const uint8_t state = operationState[i];
+        ++laneCounts[lane][state];
+
+        // Same sums as sumChunk(), with the operation in progress added through masks rather than branches
+        const double inProgress = currentOperationTime[i];
+        ModelTotals& model = laneTotals[modelIndex[i] * cLanes + lane];
+        model.totalFlightTime += (state == OperationState::en_route) * inProgress;
+        model.totalChargingTime += (state == OperationState::charging) * inProgress;
+        model.totalWaitingTime += (state == OperationState::in_charge_queue) * inProgress;
+        model.totalGroundedTime += (state == OperationState::grounded) * inProgress;
+    }
+
+    stateCounts.assign(cNumberOfOperationStates, 0);
+    modelTotals.assign(models.size(), ModelTotals{});
+    for (size_t chunk = 0; chunk < numberOfChunks(); ++chunk) {
+        for (size_t m = 0; m < models.size(); ++m) {
+            const ModelTotals& totals = chunkTotals[chunk * models.size() + m];
+            modelTotals[m].totalFlightTime += totals.totalFlightTime;
+            modelTotals[m].totalChargingTime += totals.totalChargingTime;
+            modelTotals[m].totalWaitingTime += totals.totalWaitingTime;
+            modelTotals[m].totalGroundedTime += totals.totalGroundedTime;
+            modelTotals[m].totalFaults += totals.totalFaults;
+        }
+    }
+    for (size_t lane = 0; lane < cLanes; ++lane) {
+        for (unsigned int state = 0; state < cNumberOfOperationStates; ++state) {
+            stateCounts[state] += laneCounts[lane][state];
+        }
+        for (size_t m = 0; m < models.size(); ++m) {
+            modelTotals[m].totalFlightTime += laneTotals[m * cLanes + lane].totalFlightTime;
+            modelTotals[m].totalChargingTime += laneTotals[m * cLanes + lane].totalChargingTime;
+            modelTotals[m].totalWaitingTime += laneTotals[m * cLanes + lane].totalWaitingTime;
+            modelTotals[m].totalGroundedTime += laneTotals[m * cLanes + lane].totalGroundedTime;
+        }
+    }
+}
+
+void FleetState::sumChunk(size_t chunk, vector<ModelTotals>& totals) const {
+    totals.assign(chunkTotals.begin() + chunk * models.size(), chunkTotals.begin() + (chunk + 1) * models.size());
+    VehicleIndex end = static_cast<VehicleIndex>(std::min((chunk + 1) * cChunkSize, size()));
+    for (VehicleIndex i = static_cast<VehicleIndex>(chunk * cChunkSize); i < end; ++i) {
+        ModelTotals& model = totals[modelIndex[i]];
+        model.totalFlightTime += inProgress(i, OperationState::en_route);
+        model.totalChargingTime += inProgress(i, OperationState::charging);
+        model.totalWaitingTime += inProgress(i, OperationState::in_charge_queue);
+        model.totalGroundedTime += inProgress(i, OperationState::grounded);
+    }
+}
+
+void FleetState::addModelTotals(const vector<vector<ModelTotals>>& chunkTotals) const {
+    for (const vector<ModelTotals>& totals : chunkTotals) {
+        for (size_t m = 0; m < models.size(); ++m) {
+            models[m]->totalFlightTime += totals[m].totalFlightTime;
+            models[m]->totalChargingTime += totals[m].totalChargingTime;
+            models[m]->totalWaitingTime += totals[m].totalWaitingTime;
+            models[m]->totalGroundedTime += totals[m].totalGroundedTime;
+            models[m]->totalFaults += totals[m].totalFaults;
+        }
+    }
+}
+
+void FleetState::accumulateModelTotals() const {
+    vector<vector<ModelTotals>> chunkTotals(numberOfChunks());
+    for (size_t chunk = 0; chunk < chunkTotals.size(); ++chunk) {
+        sumChunk(chunk, chunkTotals[chunk]);
+    }
+    addModelTotals(chunkTotals);
+}
+
+void FleetState::accumulateModelTotals(ThreadPool& pool) const {
+    vector<vector<ModelTotals>> chunkTotals(numberOfChunks());
+    pool.run(chunkTotals.size(), [&](size_t chunk) {
+        sumChunk(chunk, chunkTotals[chunk]);
+    });
+    addModelTotals(chunkTotals);
+}
+
+void FleetState::save(CheckpointWriter& writer) const {
+    assert(!demand && !vertiports);
+    writer.write(static_cast<uint32_t>(models.size()));
+    for (size_t m = 0; m < models.size(); ++m) {
+        writer.writeString(models[m]->params.label);
+        writer.write(modelEndurance[m]);
+        writer.write(modelTimeToCharge[m]);
+    }
+    writer.write(static_cast<uint8_t>(faults));
+    writer.writeArray(modelMeanTimeBetweenFaults);
+    writer.write(static_cast<uint64_t>(faultSeed));
+    writer.write(maintenanceTime);
+    writer.write(static_cast<uint8_t>(battery));
+    writer.write(static_cast<uint64_t>(tripSeed));
+    writer.write(minimumTripTime);
+    writer.write(maximumTripTime);
+    writer.write(chargeTo);
+    writer.write(static_cast<uint8_t>(vehicleTotals));
+
+    // The fault, battery and per vehicle total arrays are empty when they aren't kept
+    writer.writeArray(operationState);
+    writer.writeArray(modelIndex);
+    writer.writeArray(currentOperationTime);
+    writer.writeArray(operationLength);
+    writer.writeArray(queueNext);
+    writer.writeArray(flightUntilFault);
+    writer.writeArray(faultCount);
+    writer.writeArray(stateOfCharge);
+    writer.writeArray(tripCount);
+    writer.writeArray(totalTimeEnRoute);
+    writer.writeArray(totalTimeCharging);
+    writer.writeArray(totalTimeWaiting);
+    writer.writeArray(totalTimeGrounded);
+    writer.writeArray(chunkTotals);
+
+    // The sessions recorded so far, so a continued run reports the same sessions as one that never stopped
+    writer.write(static_cast<uint8_t>(sessions != nullptr));
+    if (sessions) {
+        sessions->save(writer);
+    }
+}
+
+bool FleetState::restore(CheckpointReader& reader) {
+    assert(size() == 0);
+
+    // The model table has to match the one the checkpoint was saved with
+    uint32_t numberOfModels = 0;
+    reader.read(numberOfModels);
+    if (reader.ok() && numberOfModels != models.size()) {
+        return reader.fail("checkpoint has " + std::to_string(numberOfModels) + " models, the scenario has " +
+                           std::to_string(models.size()));
+    }
+    for (size_t m = 0; m < models.size() && reader.ok(); ++m) {
+        std::string label;
+        double endurance = 0.0;
+        double timeToCharge = 0.0;
+        reader.readString(label);
+        reader.read(endurance);
+        reader.read(timeToCharge);
+        if (reader.ok() && (label != models[m]->params.label || endurance != modelEndurance[m] ||
+                            timeToCharge != modelTimeToCharge[m])) {
+            return reader.fail("checkpoint model " + label + " doesn't match the scenario");
+        }
+    }
+
+    uint8_t faultsFlag = 0;
+    uint64_t seed = 0;
+    uint8_t batteryFlag = 0;
+    uint64_t batterySeed = 0;
+    uint8_t vehicleTotalsFlag = 0;
+    vector<double> meanTimeBetweenFaults;
+    reader.read(faultsFlag);
+    reader.readArray(meanTimeBetweenFaults);
+    reader.read(seed);
+    reader.read(maintenanceTime);
+    reader.read(batteryFlag);
+    reader.read(batterySeed);
+    reader.read(minimumTripTime);
+    reader.read(maximumTripTime);
+    reader.read(chargeTo);
+    reader.read(vehicleTotalsFlag);
+    if (reader.ok() && meanTimeBetweenFaults.size() != models.size()) {
+        return reader.fail("bad checkpoint fault table");
+    }
+    faults = faultsFlag != 0;
+    modelMeanTimeBetweenFaults = meanTimeBetweenFaults;
+    faultSeed = static_cast<unsigned long>(seed);
+    battery = batteryFlag != 0;
+    tripSeed = static_cast<unsigned long>(batterySeed);
+    vehicleTotals = vehicleTotalsFlag != 0;
+
+    reader.readArray(operationState);
+    reader.readArray(modelIndex);
+    reader.readArray(currentOperationTime);
+    reader.readArray(operationLength);
+    reader.readArray(queueNext);
+    reader.readArray(flightUntilFault);
+    reader.readArray(faultCount);
+    reader.readArray(stateOfCharge);
+    reader.readArray(tripCount);
+    reader.readArray(totalTimeEnRoute);
+    reader.readArray(totalTimeCharging);
+    reader.readArray(totalTimeWaiting);
+    reader.readArray(totalTimeGrounded);
+    reader.readArray(chunkTotals);
+
+    size_t fleetSize = operationState.size();
+    size_t faultSize = faults ? fleetSize : 0;
+    size_t batterySize = battery ? fleetSize : 0;
+    size_t totalsSize = vehicleTotals ? fleetSize : 0;
+    bool consistent = reader.ok() &&
+            modelIndex.size() == fleetSize && currentOperationTime.size() == fleetSize &&
+            operationLength.size() == fleetSize && queueNext.size() == fleetSize &&
+            flightUntilFault.size() == faultSize && faultCount.size() == faultSize &&
+            stateOfCharge.size() == batterySize && tripCount.size() == batterySize &&
+            totalTimeEnRoute.size() == totalsSize && totalTimeCharging.size() == totalsSize &&
+            totalTimeWaiting.size() == totalsSize && totalTimeGrounded.size() == totalsSize &&
+            chunkTotals.size() == numberOfChunks() * models.size();
+    for (size_t v = 0; v < fleetSize && consistent; ++v) {
+        // Fleets with demand aren't saved, so nothing is parked
+        consistent = operationState[v] < OperationState::parked && modelIndex[v] < models.size() &&
+                     queueNext[v] < fleetSize;
+    }
+    if (!consistent) {
+        clear();
+        return reader.fail(reader.ok() ? "bad checkpoint fleet" : reader.getError());
+    }
+
+    uint8_t sessionsFlag = 0;
+    reader.read(sessionsFlag);
+    if (reader.ok() && sessions && sessionsFlag == 0) {
+        clear();
+        return reader.fail("checkpoint has no charging sessions");
+    }
+    if (sessionsFlag != 0) {
+        // Read past them when they aren't recorded in this run
+        SessionStatistics unrecorded(models.size());
+        if (!(sessions ? sessions : &unrecorded)->restore(reader)) {
+            clear();
+            return false;
+        }
+    }
+
+    for (FleetModelIndex model : modelIndex) {
+        ++(models[model]->fleetCount);
+    }
+    return true;
+}
+
+namespace {
+
+template <typename T>
+size_t allocated(const vector<T>& values) {
+    return values.capacity() * sizeof(T);
+}
+
+}
+
+size_t FleetState::memoryUsage() const {
+    size_t bytes = sizeof(FleetState) + allocated(operationState) + allocated(modelIndex) +
+                   allocated(currentOperationTime) + allocated(operationLength) + allocated(queueNext) +
+                   allocated(flightUntilFault) + allocated(faultCount) + allocated(stateOfCharge) +
+                   allocated(tripCount) + allocated(vertiport) + allocated(totalTimeEnRoute) +
+                   allocated(totalTimeCharging) + allocated(totalTimeWaiting) + allocated(totalTimeGrounded) +
+                   allocated(blockActive) + allocated(parkedHeap) + allocated(chunkTotals) +
+                   allocated(chunkLanded) + allocated(chunkCharged) + allocated(chunkParked) + allocated(parked) +
+                   allocated(chunkChargeSessions) + allocated(chargeSessions);
+    for (size_t chunk = 0; chunk < chunkLanded.size(); ++chunk) {
+        bytes += allocated(chunkLanded[chunk]) + allocated(chunkCharged[chunk]) + allocated(chunkParked[chunk]) +
+                 allocated(chunkChargeSessions[chunk]);
+    }
+    return bytes;
+}
+
+void FleetState::printResult(VehicleIndex vehicle) const {
+    const ModelParameters& params = models[modelIndex[vehicle]]->params;
+    cout << "Result: \n";
+    cout << "  Model                      : " << params.label << "\n";
+    cout << "  Endurance                  : " << params.endurance << "\n";
+    cout << "  Total Time In Flight (mins): " << getTotalTimeEnRoute(vehicle) << "\n";
+    cout << "  Total Time Charging (mins) : " << getTotalTimeCharging(vehicle) << "\n";
+    cout << "  Total Time Waiting (mins)  : " << getTotalTimeWaiting(vehicle) << "\n";
+    cout << "  Total Passenger Miles      : " << (getTotalTimeEnRoute(vehicle) / 60.0) * params.cruiseSpeed * params.passengerCount << "\n";
+}
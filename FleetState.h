@@ -0,0 +1,347 @@
+#ifndef _FLEET_STATE_H
+#define _FLEET_STATE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "./Geography.h"
+#include "./Statistics.h"
+#include "./Vehicle.h"
+#include "./ThreadPool.h"
+
+using std::shared_ptr;
+using std::vector;
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// Index of a model in a scenario, up to the 65536 models a scenario file can have
+typedef uint16_t ModelIndex;
+// Index of a model in the FleetState parameter table, a byte so a FleetState has at most 256 models
+typedef uint8_t FleetModelIndex;
+// Index of a vehicle in the FleetState arrays
+typedef uint32_t VehicleIndex;
+
+// A charging session that ended during a pass, see FleetState::recordSessions()
+struct ChargeSession {
+    ModelIndex model;
+    double length;
+};
+
+// Per model accumulators for the parts of the fleet that are summed separately
+struct ModelTotals {
+    double totalFlightTime;
+    double totalChargingTime;
+    double totalWaitingTime;
+    double totalGroundedTime;
+    unsigned long totalFaults;
+};
+
+// Structure-of-arrays storage for a whole fleet.
+//
+// This is the Vehicle class turned inside out: each per vehicle member lives in its own contiguous
+// array and the model parameters live in a table indexed by a one byte model index. Stepping the fleet
+// is a branch free loop over the operation times the compiler can vectorize, with no pointer chasing.
+//
+// Totals aren't written on every step. When an operation starts its start time (the overrun carried
+// over from the last one) is taken off the totals of its state, and when it ends its operation time is
+// added, so the totals are exact without keeping the start of each operation. The totals are kept per
+// model for each chunk of the fleet, in doubles, and optionally per vehicle (see keepVehicleTotals()).
+// A vehicle costs 22 bytes (state, model, operation time and length and its wait queue link) plus 12
+// with faults, 12 with the battery model, 4 with vertiports and 32 with per vehicle totals, against well
+// over 100 for a Vehicle object and the shared_ptr to it (see memoryUsage()). Times are all kept in
+// doubles, so results keep their accuracy.
+//
+// With demand (see enableDemand()) vehicles park between trips and blocks of parked vehicles skip the
+// per step update altogether, so a mostly parked fleet steps in proportion to the vehicles in use.
+//
+// The fleet can be stepped across a ThreadPool. Work is split into fixed size chunks and anything
+// gathered per chunk (landed vehicles, model totals) is combined in chunk order, so results are the same
+// for any number of threads.
+class FleetState {
+private:
+    // Shared model records, indexed by ModelIndex
+    vector<shared_ptr<ModelData>> models;
+
+    // Per model parameter table, indexed by ModelIndex
+    vector<double> modelEndurance;
+    vector<double> modelTimeToCharge;
+    vector<double> modelMeanTimeBetweenFaults;  // Flight minutes, infinite without faults
+
+    // Fault settings, see enableFaults()
+    bool faults;
+    unsigned long faultSeed;
+    double maintenanceTime;
+
+    // Battery settings, see enableBattery()
+    bool battery;
+    unsigned long tripSeed;
+    double minimumTripTime;
+    double maximumTripTime;                // Infinite to fly until the battery is flat
+    double chargeTo;                       // Fraction of a full battery a vehicle leaves the charger with
+
+    // Trips between vertiports, null without, see enableVertiports()
+    shared_ptr<const VertiportMap> vertiports;
+    vector<double> modelMinutesPerMile;
+
+    // Per vehicle totals are kept, see keepVehicleTotals()
+    bool vehicleTotals;
+
+    // Vehicles park between trips, see enableDemand()
+    bool demand;
+
+    // Where waits and charging sessions are recorded, null for nowhere, see recordSessions()
+    SessionStatistics* sessions;
+
+    // Per vehicle state, indexed by VehicleIndex
+    vector<uint8_t> operationState;        // OperationState, plus cTransitionFlag while a change is pending
+    vector<FleetModelIndex> modelIndex;
+    vector<double> currentOperationTime;   // Duration of current operation mode
+    vector<double> operationLength;        // Flight or charge length, whichever ends the current mode
+    vector<VehicleIndex> queueNext;        // Next vehicle in the same charging station wait queue
+
+    // Per vehicle fault state, empty without faults
+    vector<double> flightUntilFault;       // Flight minutes left before the next fault
+    vector<uint32_t> faultCount;
+
+    // Per vehicle battery state, empty without the battery model. The state of charge only changes when
+    // an operation ends, from the operation's length, so the per step update doesn't touch it.
+    vector<double> stateOfCharge;          // Fraction of a full battery when the current operation started
+    vector<uint32_t> tripCount;            // Trips flown, numbers the draw of the next trip
+
+    // Per vehicle vertiport, empty without vertiports. Where the vehicle took off from while it flies,
+    // where it is otherwise.
+    vector<VertiportIndex> vertiport;
+
+    // Per vehicle totals in simulated minutes, empty unless they are kept. Completed operations less the
+    // start of the operation in progress, same as chunkTotals.
+    vector<double> totalTimeEnRoute;
+    vector<double> totalTimeCharging;
+    vector<double> totalTimeWaiting;
+    vector<double> totalTimeGrounded;
+
+    // Demand state, empty without demand. Each block of cBlockSize vehicles counts the ones that aren't
+    // parked and is skipped while it has none. The parked vehicles are kept in a min-heap so the lowest
+    // index is woken first, which keeps the vehicles in use packed into the low blocks.
+    vector<uint16_t> blockActive;
+    vector<VehicleIndex> parkedHeap;
+
+    // Totals of completed operations less the start of the operations in progress, indexed by
+    // chunk * number of models + ModelIndex. The operations in progress are added when totals are read.
+    vector<ModelTotals> chunkTotals;
+
+    // Vehicles that landed or finished charging in each chunk during a parallel iterate()
+    vector<vector<VehicleIndex>> chunkLanded;
+    vector<vector<VehicleIndex>> chunkCharged;
+    vector<vector<VehicleIndex>> chunkParked;
+    vector<vector<ChargeSession>> chunkChargeSessions;
+
+    // Vehicles parked and charging sessions ended during a single threaded iterate()
+    vector<VehicleIndex> parked;
+    vector<ChargeSession> chargeSessions;
+
+    // Vectorizable part of iterate(), returns the number of vehicles that changed state
+    unsigned int iterateBlock(size_t begin, size_t end, double deltaT);
+
+    // iterate() over the vehicles in [begin, end), begin must be at a block boundary. charged may be null,
+    // vehicles that park are appended to parked and charging sessions that end (when they are recorded)
+    // to chargeSessions.
+    void iterateRange(size_t begin, size_t end, double deltaT, vector<VehicleIndex>& landed,
+                      vector<VehicleIndex>* charged, vector<VehicleIndex>& parked,
+                      vector<ChargeSession>& chargeSessions);
+
+    // Record the charging sessions that ended on a pass, if sessions are recorded
+    void addChargeSessions(const vector<ChargeSession>& ended);
+
+    // Put a vehicle the scalar pass has settled into the parked state
+    void park(size_t vehicle);
+
+    // Add the vehicles parked by a pass to the heap of parked vehicles
+    void addParked(const vector<VehicleIndex>& vehicles);
+
+    // iterate() with the chunks spread across the pool, charged may be null
+    void iterateChunks(double deltaT, vector<VehicleIndex>& landed, vector<VehicleIndex>* charged, ThreadPool& pool);
+
+    // Sum the per vehicle totals of one chunk into a per model table
+    void sumChunk(size_t chunk, vector<ModelTotals>& totals) const;
+
+    // Add per chunk model totals into the ModelData records in chunk order
+    void addModelTotals(const vector<vector<ModelTotals>>& chunkTotals) const;
+
+    // Add time to the totals of a vehicle for the given state: the operation time when an operation
+    // ends, less the operation time when one starts. Untimed states are ignored.
+    void addTime(size_t vehicle, uint8_t state, double time);
+
+    // Operation time of the current operation if it is the given state, otherwise 0
+    double inProgress(VehicleIndex vehicle, OperationState state) const;
+
+    // Flight minutes from the fault numbered faultNumber of a vehicle to the next one
+    double drawFlightUntilFault(VehicleIndex vehicle, ModelIndex model, uint32_t faultNumber) const;
+
+    // Destination of the next trip of a vehicle, needs vertiports
+    VertiportIndex tripDestination(VehicleIndex vehicle) const;
+
+    // Flight minutes of the next trip of a vehicle, infinite without trip times or vertiports
+    double tripTime(VehicleIndex vehicle) const;
+
+    // Fraction of a full battery a vehicle charges up to: chargeTo, or enough for its next trip
+    double chargeTarget(VehicleIndex vehicle) const;
+
+    // Length of an en_route operation: the endurance, or with the battery model the next trip or
+    // whatever the battery has left. Cut short by the next fault.
+    double flightLength(VehicleIndex vehicle) const;
+
+public:
+    // Vehicles are iterated in blocks so blocks without state changes can skip the scalar pass
+    static const size_t cBlockSize = 256;
+    // Set in operationState by iterateBlock() for vehicles whose state changed
+    static const uint8_t cTransitionFlag = 0x80;
+    // Vehicles per unit of parallel work, fixed so results don't depend on the number of threads
+    static const size_t cChunkSize = 64 * cBlockSize;
+    // Most models a FleetModelIndex can refer to, scenarios with more run on the tick and event engines
+    static const size_t cMaxModels = 256;
+
+    // Model records are shared with the caller, their fleetCount is updated by addVehicle()
+    explicit FleetState(const vector<shared_ptr<ModelData>>& models);
+
+    // Prevent unneeded defaults
+    FleetState(const FleetState&) = delete;
+    FleetState& operator=(const FleetState&) = delete;
+
+    void reserve(size_t fleetSize);
+
+    // Simulate faults from here on: each vehicle faults as a Poisson process over its flight time, at
+    // its model's MaxFaultsPerHour, and is grounded for maintenanceTime minutes before flying again
+    // (maintenance includes a recharge). The flight time to the next fault is drawn when a vehicle is
+    // added and after each fault, from a hash of (seed, vehicle, fault number), so the cost doesn't
+    // depend on the step size and results don't depend on the number of threads. Call before adding
+    // vehicles.
+    void enableFaults(unsigned long seed, double maintenanceTime);
+
+    // Model each vehicle's battery from here on. Vehicles start full, flying drains the battery over the
+    // model's endurance and charging fills it over timeToCharge. With trip times a vehicle flies trips of
+    // between minimumTripTime and maximumTripTime minutes, drawn from a hash of (seed, vehicle, trip
+    // number), and only lands to charge when its battery can't cover the next trip. Without them
+    // (maximumTripTime infinite) it flies until the battery is flat. Charging stops at chargeTo of a full
+    // battery, or at enough for the next trip if that is more. Faults flatten nothing, maintenance leaves
+    // the battery full. Call before adding vehicles.
+    void enableBattery(unsigned long seed, double minimumTripTime, double maximumTripTime, double chargeTo);
+    bool hasBattery() const { return battery; }
+
+    // Fly trips between the vertiports of a map from here on, in place of the battery model's trip times.
+    // Each vehicle starts at a vertiport and each trip goes to one of the others, both drawn from a hash
+    // of (battery seed, vehicle, trip number), and takes the distance over the model's cruise speed. A
+    // vehicle that needs a charge is moved to the vertiport of the charging station it is sent to (see
+    // StationNetwork), the hop there isn't flown. A trip longer than the battery has charge for ends where
+    // the battery runs out, which counts as arriving. Needs enableBattery() and at least two vertiports,
+    // call before adding vehicles.
+    void enableVertiports(shared_ptr<const VertiportMap> map);
+    bool hasVertiports() const { return vertiports != nullptr; }
+    const VertiportMap& getVertiportMap() const { return *vertiports; }
+
+    // Keep totals for each vehicle as well as for each model (the default), for the per vehicle
+    // accessors and printResult(). Large fleets that only report model totals save 32 bytes a vehicle
+    // without them. Call before adding vehicles.
+    void keepVehicleTotals(bool keep);
+    bool hasVehicleTotals() const { return vehicleTotals; }
+
+    // Park vehicles between trips from here on, for a demand profile to wake them (see Demand.h).
+    // Vehicles start parked, and instead of going straight back in the air they park after each trip
+    // they have the charge left for, after charging and after maintenance. Without the battery model
+    // a trip is a flight until the battery is flat, followed by a charge. Call before adding vehicles.
+    void enableDemand();
+    bool hasDemand() const { return demand; }
+
+    // Number of vehicles parked
+    size_t numberParked() const { return parkedHeap.size(); }
+
+    // Send the parked vehicle with the lowest index on a trip and return it, there must be one
+    VehicleIndex wake();
+
+    // Record the wait of every vehicle that starts charging, from joining a charging station's queue,
+    // and the length of every charging session that ends into statistics from here on, null to stop.
+    // Sessions that end on a parallel iterate() are recorded in index order once the pass is done, so
+    // the statistics are only touched on the calling thread.
+    void recordSessions(SessionStatistics* statistics);
+
+    // Remove all vehicles, keeping the allocated memory for the next fleet. The model records are
+    // left alone.
+    void clear();
+
+    // Add an en_route vehicle of the given model (parked with demand), returns its index
+    VehicleIndex addVehicle(ModelIndex model);
+
+    size_t size() const;
+
+    // Number of cChunkSize pieces the fleet is split into for parallel work
+    size_t numberOfChunks() const;
+
+    // Iterate every vehicle by delta-time in simulated minutes, same rules as Vehicle::iterate().
+    // Vehicles that finish their flight are appended to landed in index order, they are left in
+    // the "waiting_for_charge_queue" state for the charging station to pick up.
+    void iterate(double deltaT, vector<VehicleIndex>& landed);
+
+    // Same as above with the chunks spread across the pool, landed is in the same (index) order
+    void iterate(double deltaT, vector<VehicleIndex>& landed, ThreadPool& pool);
+
+    // Same as above, also appending the vehicles that finished charging (and are back en_route) to
+    // charged in index order, so their charging station doesn't have to look for them
+    void iterate(double deltaT, vector<VehicleIndex>& landed, vector<VehicleIndex>& charged);
+    void iterate(double deltaT, vector<VehicleIndex>& landed, vector<VehicleIndex>& charged, ThreadPool& pool);
+
+    // Index based counterparts of the IChargeable interface for the FleetChargingStation
+    void setCharging(VehicleIndex vehicle);
+    bool isCharging(VehicleIndex vehicle) const;
+    void setInWaitQueue(VehicleIndex vehicle);
+    bool isWaitingForQueue(VehicleIndex vehicle) const;
+
+    // Link to the next vehicle in a charging station wait queue. A vehicle waits in one queue at a
+    // time, so stations thread their queues through this instead of allocating their own.
+    VehicleIndex getQueueNext(VehicleIndex vehicle) const { return queueNext[vehicle]; }
+    void setQueueNext(VehicleIndex vehicle, VehicleIndex next) { queueNext[vehicle] = next; }
+
+    // Accessors, the totals include the operation in progress and need keepVehicleTotals()
+    OperationState getOpState(VehicleIndex vehicle) const;
+    ModelIndex getModel(VehicleIndex vehicle) const;
+    double getTotalTimeEnRoute(VehicleIndex vehicle) const;
+    double getTotalTimeCharging(VehicleIndex vehicle) const;
+    double getTotalTimeWaiting(VehicleIndex vehicle) const;
+    double getTotalTimeGrounded(VehicleIndex vehicle) const;
+    uint32_t getFaultCount(VehicleIndex vehicle) const;
+
+    // Fraction of a full battery left, including the operation in progress. Needs enableBattery().
+    double getStateOfCharge(VehicleIndex vehicle) const;
+
+    // Vertiport a vehicle is at, or took off from while it flies. Needs enableVertiports().
+    VertiportIndex getVertiport(VehicleIndex vehicle) const { return vertiport[vehicle]; }
+    Position getPosition(VehicleIndex vehicle) const { return vertiports->position(vertiport[vehicle]); }
+    void setVertiport(VehicleIndex vehicle, VertiportIndex at);
+
+    // Number of vehicles in each OperationState (cNumberOfOperationStates entries) and per model totals
+    // so far, including the operations in progress. Doesn't touch the ModelData records.
+    void sample(vector<uint64_t>& stateCounts, vector<ModelTotals>& modelTotals) const;
+
+    // Add the per vehicle totals into the totals of the shared ModelData records. Totals are summed
+    // per chunk and the chunks are added in order, with or without a pool.
+    void accumulateModelTotals() const;
+    void accumulateModelTotals(ThreadPool& pool) const;
+
+    // Write the model table, fault settings, every per vehicle array and the sessions recorded so far
+    // (see recordSessions()) to a checkpoint. A fleet with demand can't be checkpointed, the requests
+    // aren't part of the fleet, and neither can one with vertiports, the map isn't either.
+    void save(CheckpointWriter& writer) const;
+
+    // Read back what save() wrote into an empty fleet built with the same models, updating the
+    // fleetCount of the model records and restoring the recorded sessions into the statistics set with
+    // recordSessions(). Returns false with the reason in the reader on a mismatch.
+    bool restore(CheckpointReader& reader);
+
+    // Print out results for one vehicle, same format as Vehicle::printResult(). Needs keepVehicleTotals().
+    void printResult(VehicleIndex vehicle) const;
+
+    // Bytes allocated for the fleet, including the space reserved for vehicles not added yet
+    size_t memoryUsage() const;
+};
+
+#endif //_FLEET_STATE_H
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "./Geography.h"
+#include "./RandomStream.h"
+
+namespace {
+
+// Keeps the vertiport layout apart from the other draws made from the same seed
+const uint64_t cLayoutDraws = 0x1B873593UL;
+
+}
+
+double distance(Position a, Position b) {
+    return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+VertiportMap::VertiportMap(size_t count, double area, unsigned long seed) {
+    assert(area > 0.0);
+    // Each vertiport from draws of its own
+    positions.reserve(count);
+    for (size_t v = 0; v < count; ++v) {
+        const VertiportIndex vertiport = static_cast<VertiportIndex>(v);
+        positions.push_back(Position{uniformDraw(seed ^ cLayoutDraws, vertiport, 0) * area,
+                                     uniformDraw(seed ^ cLayoutDraws, vertiport, 1) * area});
+    }
+}
+
+VertiportMap::VertiportMap(const vector<Position>& positions) : positions(positions) {}
+
+VertiportIndex VertiportMap::destination(VertiportIndex from, double draw) const {
+    assert(positions.size() >= 2 && draw >= 0.0 && draw < 1.0);
+    // Draw from the others by skipping over the one we're at
+    VertiportIndex to = static_cast<VertiportIndex>(draw * static_cast<double>(positions.size() - 1));
+    to = std::min(to, static_cast<VertiportIndex>(positions.size() - 2));
+    return to >= from ? to + 1 : to;
+}
+
+size_t VertiportMap::memoryUsage() const {
+    return sizeof(VertiportMap) + positions.capacity() * sizeof(Position);
+}
+
+NearestIndex::NearestIndex(const vector<Position>& points) {
+    assert(!points.empty());
+    double maximumX = points[0].x;
+    double maximumY = points[0].y;
+    minimumX = maximumX;
+    minimumY = maximumY;
+    for (const Position& point : points) {
+        minimumX = std::min(minimumX, point.x);
+        minimumY = std::min(minimumY, point.y);
+        maximumX = std::max(maximumX, point.x);
+        maximumY = std::max(maximumY, point.y);
+    }
+
+    // Square cells of about cPointsPerCell points each over the bounding box. Points in a line or all in
+    // one place have a box with no area, those fall back on the length of the box or a single cell.
+    const double width = maximumX - minimumX;
+    const double height = maximumY - minimumY;
+    const double cells = std::max(static_cast<double>(points.size()) / cPointsPerCell, 1.0);
+    cellSize = width * height > 0.0 ? std::sqrt(width * height / cells) : std::max(width, height) / cells;
+    if (!(cellSize > 0.0)) {
+        cellSize = 1.0;
+    }
+    inverseCellSize = 1.0 / cellSize;
+    columns = static_cast<uint32_t>(width * inverseCellSize) + 1;
+    rows = static_cast<uint32_t>(height * inverseCellSize) + 1;
+
+    // Counting sort of the points by cell
+    vector<uint32_t> pointCell(points.size());
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+    for (size_t p = 0; p < points.size(); ++p) {
+        uint32_t column = std::min(static_cast<uint32_t>((points[p].x - minimumX) * inverseCellSize), columns - 1);
+        uint32_t row = std::min(static_cast<uint32_t>((points[p].y - minimumY) * inverseCellSize), rows - 1);
+        pointCell[p] = row * columns + column;
+        ++cellStart[pointCell[p] + 1];
+    }
+    for (size_t cell = 1; cell < cellStart.size(); ++cell) {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+    cellPositions.resize(points.size());
+    cellPoints.resize(points.size());
+    vector<uint32_t> next(cellStart.begin(), cellStart.end() - 1);
+    for (size_t p = 0; p < points.size(); ++p) {
+        uint32_t entry = next[pointCell[p]]++;
+        cellPositions[entry] = points[p];
+        cellPoints[entry] = static_cast<uint32_t>(p);
+    }
+}
+
+uint32_t NearestIndex::nearest(Position position) const {
+    // Cell of the position, positions outside the box start from the closest cell on its edge
+    const double x = (position.x - minimumX) * inverseCellSize;
+    const double y = (position.y - minimumY) * inverseCellSize;
+    const int64_t column = static_cast<int64_t>(std::min(std::max(x, 0.0), static_cast<double>(columns - 1)));
+    const int64_t row = static_cast<int64_t>(std::min(std::max(y, 0.0), static_cast<double>(rows - 1)));
+
+    double best = std::numeric_limits<double>::infinity();  // Squared distance
+    uint32_t bestPoint = std::numeric_limits<uint32_t>::max();
+    for (int64_t ring = 0;; ++ring) {
+        const int64_t top = std::max<int64_t>(row - ring, 0);
+        const int64_t bottom = std::min<int64_t>(row + ring, rows - 1);
+        for (int64_t r = top; r <= bottom; ++r) {
+            // Whole rows at the top and bottom of the ring, just the two ends in between
+            const bool edge = r == row - ring || r == row + ring;
+            const int64_t step = edge || ring == 0 ? 1 : 2 * ring;
+            for (int64_t c = column - ring; c <= column + ring; c += step) {
+                if (c < 0 || c >= columns) {
+                    continue;
+                }
+                const size_t cell = static_cast<size_t>(r * columns + c);
+                for (uint32_t entry = cellStart[cell]; entry < cellStart[cell + 1]; ++entry) {
+                    const double dx = cellPositions[entry].x - position.x;
+                    const double dy = cellPositions[entry].y - position.y;
+                    const double squared = dx * dx + dy * dy;
+                    if (squared < best || (squared == best && cellPoints[entry] < bestPoint)) {
+                        best = squared;
+                        bestPoint = cellPoints[entry];
+                    }
+                }
+            }
+        }
+        // Every point in the rings further out is beyond the nearest side of the square scanned so far
+        // that isn't on the edge of the grid, once all four are on the edge there is nothing further out
+        double reach = std::numeric_limits<double>::infinity();
+        if (column - ring > 0) {
+            reach = std::min(reach, x - static_cast<double>(column - ring));
+        }
+        if (column + ring + 1 < columns) {
+            reach = std::min(reach, static_cast<double>(column + ring + 1) - x);
+        }
+        if (row - ring > 0) {
+            reach = std::min(reach, y - static_cast<double>(row - ring));
+        }
+        if (row + ring + 1 < rows) {
+            reach = std::min(reach, static_cast<double>(row + ring + 1) - y);
+        }
+        reach *= cellSize;
+        if (best <= reach * reach) {
+            break;
+        }
+    }
+    return bestPoint;
+}
+
+size_t NearestIndex::memoryUsage() const {
+    return sizeof(NearestIndex) + cellStart.capacity() * sizeof(uint32_t) +
+           cellPositions.capacity() * sizeof(Position) + cellPoints.capacity() * sizeof(uint32_t);
+}
@@ -0,0 +1,83 @@
+#ifndef _GEOGRAPHY_H
+#define _GEOGRAPHY_H
+
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+// Index of a vertiport in a VertiportMap
+typedef uint32_t VertiportIndex;
+
+// A point on the map, in miles
+struct Position {
+    double x;
+    double y;
+};
+
+// Straight line distance in miles
+double distance(Position a, Position b);
+
+// Vertiports a fleet engine run flies trips between (see FleetState::enableVertiports()).
+//
+// The vertiports are spread uniformly at random over a square, laid out from the scenario seed so every
+// replication of a scenario flies over the same map. The charging stations of the run are at the first
+// vertiports, station s at vertiport s, so there must be at least as many vertiports as stations.
+class VertiportMap {
+private:
+    vector<Position> positions;
+
+public:
+    // count vertiports spread over a square area miles on a side
+    VertiportMap(size_t count, double area, unsigned long seed);
+
+    // Vertiports at the given positions
+    explicit VertiportMap(const vector<Position>& positions);
+
+    size_t size() const { return positions.size(); }
+    Position position(VertiportIndex vertiport) const { return positions[vertiport]; }
+    const vector<Position>& getPositions() const { return positions; }
+
+    // Destination of a trip from a vertiport for a uniform draw in [0, 1): each of the other vertiports
+    // is equally likely. Needs at least two vertiports.
+    VertiportIndex destination(VertiportIndex from, double draw) const;
+
+    // Bytes allocated for the positions
+    size_t memoryUsage() const;
+};
+
+// Nearest neighbour index over a fixed set of points, for finding the charging station closest to
+// where a vehicle lands.
+//
+// The bounding box of the points is cut into a uniform grid of square cells, about cPointsPerCell points
+// to a cell, and the points are stored cell by cell. A query scans rings of cells outward from the
+// cell the query falls in and stops once the nearest point found is closer than anything the next ring
+// could hold, so a query touches a handful of cells whatever the number of points. Points are assumed
+// to be spread fairly evenly, a tight cluster in a wide box makes for crowded cells.
+class NearestIndex {
+private:
+    static const size_t cPointsPerCell = 2;
+
+    double minimumX;
+    double minimumY;
+    double cellSize;                  // Miles on a side
+    double inverseCellSize;
+    uint32_t columns;
+    uint32_t rows;
+
+    vector<uint32_t> cellStart;       // First entry of each cell in cellPoints, row by row, plus the end
+    vector<Position> cellPositions;   // Positions cell by cell
+    vector<uint32_t> cellPoints;      // Index of each of those positions in the original set
+
+public:
+    // Index points, there must be at least one
+    explicit NearestIndex(const vector<Position>& points);
+
+    // Index of the point nearest a position, lowest index on ties
+    uint32_t nearest(Position position) const;
+
+    // Bytes allocated for the grid
+    size_t memoryUsage() const;
+};
+
+#endif //_GEOGRAPHY_H
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cmath>
+
+#include "./Checkpoint.h"
+#include "./Histogram.h"
+
+namespace {
+
+// Index of the highest set bit, value must not be 0
+unsigned int highestBit(uint64_t value) {
+    return 63 - static_cast<unsigned int>(__builtin_clzll(value));
+}
+
+}
+
+// Out of line definitions so the constants can be bound to references
+const unsigned int LatencyHistogram::cSubBucketBits;
+const size_t LatencyHistogram::cSubBuckets;
+const size_t LatencyHistogram::cNumberOfBuckets;
+
+LatencyHistogram::LatencyHistogram() :
+        count(0),
+        total(0),
+        minimum(UINT64_MAX),
+        maximum(0)
+{}
+
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+    // Values below cSubBuckets have a bucket each, above that each power of 2 is split into cSubBuckets
+    if (value < cSubBuckets) {
+        return static_cast<size_t>(value);
+    }
+    unsigned int shift = highestBit(value) - cSubBucketBits;
+    return (shift + 1) * cSubBuckets + static_cast<size_t>((value >> shift) - cSubBuckets);
+}
+
+uint64_t LatencyHistogram::bucketHighest(size_t bucket) {
+    if (bucket < cSubBuckets) {
+        return bucket;
+    }
+    unsigned int shift = static_cast<unsigned int>(bucket / cSubBuckets) - 1;
+    uint64_t lowest = static_cast<uint64_t>(cSubBuckets + bucket % cSubBuckets) << shift;
+    return lowest + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    if (counts.empty()) {
+        counts.assign(cNumberOfBuckets, 0);
+    }
+    ++counts[bucketOf(value)];
+    ++count;
+    total += value;
+    minimum = std::min(minimum, value);
+    maximum = std::max(maximum, value);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.counts.empty()) {
+        return;
+    }
+    if (counts.empty()) {
+        counts.assign(cNumberOfBuckets, 0);
+    }
+    for (size_t b = 0; b < cNumberOfBuckets; ++b) {
+        counts[b] += other.counts[b];
+    }
+    count += other.count;
+    total += other.total;
+    minimum = std::min(minimum, other.minimum);
+    maximum = std::max(maximum, other.maximum);
+}
+
+void LatencyHistogram::clear() {
+    std::fill(counts.begin(), counts.end(), 0);
+    count = 0;
+    total = 0;
+    minimum = UINT64_MAX;
+    maximum = 0;
+}
+
+void LatencyHistogram::save(CheckpointWriter& writer) const {
+    // The table is empty until something is recorded
+    writer.writeArray(counts);
+    writer.write(count);
+    writer.write(total);
+    writer.write(minimum);
+    writer.write(maximum);
+}
+
+bool LatencyHistogram::restore(CheckpointReader& reader) {
+    reader.readArray(counts);
+    reader.read(count);
+    reader.read(total);
+    reader.read(minimum);
+    reader.read(maximum);
+    uint64_t counted = 0;
+    for (uint64_t bucketCount : counts) {
+        counted += bucketCount;
+    }
+    if (!reader.ok() || (!counts.empty() && counts.size() != cNumberOfBuckets) || counted != count) {
+        counts.clear();
+        clear();
+        return reader.fail(reader.ok() ? "bad checkpoint histogram" : reader.getError());
+    }
+    return true;
+}
+
+double LatencyHistogram::getMean() const {
+    return count > 0 ? static_cast<double>(total) / static_cast<double>(count) : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (count == 0) {
+        return 0;
+    }
+    // Rank of the value, at least the first one
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::min(std::max(p, 0.0), 1.0) * static_cast<double>(count)));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < counts.size(); ++b) {
+        seen += counts[b];
+        if (seen >= rank) {
+            return std::min(bucketHighest(b), maximum);
+        }
+    }
+    return maximum;
+}
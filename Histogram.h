@@ -0,0 +1,57 @@
+#ifndef _HISTOGRAM_H
+#define _HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+class CheckpointWriter;
+class CheckpointReader;
+
+// HDR style histogram of non-negative integer values (nanoseconds for the profiler). Values are bucketed
+// by their highest set bit and the cSubBucketBits bits below it, so every value is kept to within 1 part
+// in 2^cSubBucketBits (better than 1%) from 1 up to 2^64 in a fixed table, and recording is a couple of
+// bit operations and an increment. Histograms with the same layout merge by adding their counts, exactly
+// and in any order. The table (about 58KB) is only allocated once something is recorded or merged in.
+class LatencyHistogram {
+public:
+    static const unsigned int cSubBucketBits = 7;
+    static const size_t cSubBuckets = size_t(1) << cSubBucketBits;
+    static const size_t cNumberOfBuckets = (64 - cSubBucketBits + 1) * cSubBuckets;
+
+    LatencyHistogram();
+
+    void record(uint64_t value);
+    void merge(const LatencyHistogram& other);
+    void clear();
+
+    // Write the counts to a checkpoint, and read them back into this histogram. restore() returns false
+    // with the reason in the reader if the counts don't add up.
+    void save(CheckpointWriter& writer) const;
+    bool restore(CheckpointReader& reader);
+
+    uint64_t getCount() const { return count; }
+    uint64_t getTotal() const { return total; }
+    uint64_t getMinimum() const { return count > 0 ? minimum : 0; }
+    uint64_t getMaximum() const { return maximum; }
+    double getMean() const;
+
+    // The value below which the fraction p (0 to 1) of the recorded values fall, as the highest value of
+    // its bucket (capped at the maximum). 0 when nothing has been recorded.
+    uint64_t percentile(double p) const;
+
+    // Bucket layout, public for tests
+    static size_t bucketOf(uint64_t value);
+    static uint64_t bucketHighest(size_t bucket);
+
+private:
+    vector<uint64_t> counts;
+    uint64_t count;
+    uint64_t total;
+    uint64_t minimum;
+    uint64_t maximum;
+};
+
+#endif //_HISTOGRAM_H
@@ -0,0 +1,260 @@
+#include <cassert>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "./LiveExport.h"
+
+// Readers map the segment read only, the atomics they load from it must not need to write
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "live export needs lock free 64 bit atomics");
+
+namespace {
+
+const char cMagic[8] = {'J', 'O', 'B', 'Y', 'L', 'I', 'V', '\0'};
+const uint32_t cVersion = 1;
+
+struct LiveHeader {
+    char magic[8];
+    std::atomic<uint32_t> version;  // 0 until the rest of the segment is ready
+    uint32_t numberOfStates;
+    uint32_t numberOfModels;
+};
+
+// Snapshot word indexes, the state counts and model totals follow cStateCounts
+const size_t cTime = 0;
+const size_t cFinished = 1;
+const size_t cWaiting = 2;
+const size_t cCharging = 3;
+const size_t cStateCounts = 4;
+
+size_t roundUp(size_t offset, size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+std::string segmentName(const std::string& name) {
+    return !name.empty() && name[0] == '/' ? name : "/" + name;
+}
+
+uint64_t doubleBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsDouble(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+}
+
+LiveSegmentLayout::LiveSegmentLayout(size_t numberOfModels) :
+        numberOfModels(numberOfModels),
+        labelsOffset(roundUp(sizeof(LiveHeader), cCacheLine)),
+        sequenceOffset(roundUp(labelsOffset + numberOfModels * cLabelSize, cCacheLine)),
+        snapshotOffset(sequenceOffset + cCacheLine),
+        snapshotWords(cStateCounts + cNumberOfOperationStates + 3 * numberOfModels),
+        size(snapshotOffset + snapshotWords * sizeof(uint64_t))
+{}
+
+LiveExport::LiveExport(const std::string& name, double interval, const vector<shared_ptr<ModelData>>& models) :
+        cInterval(interval),
+        nextPublishTime(0.0),
+        name(segmentName(name)),
+        models(models),
+        layout(models.size()),
+        segment(nullptr),
+        sequence(nullptr),
+        snapshot(nullptr),
+        stateCounts(cNumberOfOperationStates, 0),
+        modelTotals(models.size(), ModelTotals{0.0, 0.0, 0.0, 0.0, 0})
+{
+    assert(interval > 0.0);
+    // A segment left by an earlier run is unlinked rather than reused, so readers still mapping it keep
+    // its last snapshot instead of seeing it change size under them
+    shm_unlink(this->name.c_str());
+    int fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        return;
+    }
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(layout.size)) == 0) {
+        memory = mmap(nullptr, layout.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(this->name.c_str());
+        return;
+    }
+    segment = memory;
+
+    // The segment starts out 0 filled, the version is stored last so a reader never sees half a header
+    char* bytes = static_cast<char*>(segment);
+    LiveHeader* header = reinterpret_cast<LiveHeader*>(bytes);
+    std::memcpy(header->magic, cMagic, sizeof(cMagic));
+    header->numberOfStates = cNumberOfOperationStates;
+    header->numberOfModels = static_cast<uint32_t>(models.size());
+    for (size_t m = 0; m < models.size(); ++m) {
+        std::strncpy(bytes + layout.labelsOffset + m * LiveSegmentLayout::cLabelSize,
+                     models[m]->params.label.c_str(), LiveSegmentLayout::cLabelSize - 1);
+    }
+    sequence = new (bytes + layout.sequenceOffset) std::atomic<uint64_t>(0);
+    snapshot = reinterpret_cast<std::atomic<uint64_t>*>(bytes + layout.snapshotOffset);
+    for (size_t w = 0; w < layout.snapshotWords; ++w) {
+        new (&snapshot[w]) std::atomic<uint64_t>(0);
+    }
+    new (&header->version) std::atomic<uint32_t>(0);
+    header->version.store(cVersion, std::memory_order_release);
+}
+
+LiveExport::~LiveExport() {
+    if (!segment) {
+        return;
+    }
+    store(bitsDouble(snapshot[cTime].load(std::memory_order_relaxed)), true,
+          snapshot[cWaiting].load(std::memory_order_relaxed), snapshot[cCharging].load(std::memory_order_relaxed));
+    munmap(segment, layout.size);
+    shm_unlink(name.c_str());
+}
+
+// Seqlock write: the odd sequence number is ordered before the snapshot stores by the release fence,
+// and the snapshot stores before the next even one by its release store
+void LiveExport::store(double time, bool finished, uint64_t waiting, uint64_t charging) {
+    const std::memory_order relaxed = std::memory_order_relaxed;
+    uint64_t current = sequence->load(relaxed);
+    sequence->store(current + 1, relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    snapshot[cTime].store(doubleBits(time), relaxed);
+    snapshot[cFinished].store(finished ? 1 : 0, relaxed);
+    snapshot[cWaiting].store(waiting, relaxed);
+    snapshot[cCharging].store(charging, relaxed);
+    std::atomic<uint64_t>* counts = snapshot + cStateCounts;
+    for (size_t s = 0; s < cNumberOfOperationStates; ++s) {
+        counts[s].store(stateCounts[s], relaxed);
+    }
+    std::atomic<uint64_t>* totals = counts + cNumberOfOperationStates;
+    for (size_t m = 0; m < layout.numberOfModels; ++m) {
+        totals[3 * m].store(doubleBits(modelTotals[m].totalFlightTime), relaxed);
+        totals[3 * m + 1].store(doubleBits(modelTotals[m].totalChargingTime), relaxed);
+        totals[3 * m + 2].store(doubleBits(modelTotals[m].totalWaitingTime), relaxed);
+    }
+
+    sequence->store(current + 2, std::memory_order_release);
+    while (nextPublishTime <= time) {
+        nextPublishTime += cInterval;
+    }
+}
+
+void LiveExport::publish(double time, const FleetState& fleet, const StationNetwork& stations) {
+    fleet.sample(stateCounts, modelTotals);
+    store(time, false, stations.getNumberWaiting(), stations.getNumberCharging());
+}
+
+void LiveExport::publish(double time, const vector<shared_ptr<Vehicle>>& vehicles,
+                         const ChargingStation& chargingStation) {
+    sampleVehicles(vehicles, models, stateCounts, modelTotals);
+    store(time, false, chargingStation.getNumberWaiting(), chargingStation.getNumberCharging());
+}
+
+LiveReader::LiveReader() :
+        segment(nullptr),
+        size(0),
+        sequence(nullptr),
+        snapshot(nullptr)
+{}
+
+LiveReader::~LiveReader() {
+    if (segment) {
+        munmap(const_cast<void*>(segment), size);
+    }
+}
+
+bool LiveReader::open(const std::string& name, std::string& error) {
+    assert(!segment);
+    const std::string path = segmentName(name);
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        error = path + ": no live export segment, is the simulation running with --live?";
+        return false;
+    }
+    struct stat status;
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) >= sizeof(LiveHeader)) {
+        size = static_cast<size_t>(status.st_size);
+        memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (memory == MAP_FAILED) {
+        error = path + ": not a live export segment";
+        return false;
+    }
+
+    const char* bytes = static_cast<const char*>(memory);
+    const LiveHeader* header = reinterpret_cast<const LiveHeader*>(bytes);
+    // The version is stored last, so it is loaded first
+    uint32_t version = header->version.load(std::memory_order_acquire);
+    if (version == 0) {
+        error = path + ": live export segment not ready yet";
+    } else if (std::memcmp(header->magic, cMagic, sizeof(cMagic)) != 0) {
+        error = path + ": not a live export segment";
+    } else if (version != cVersion) {
+        error = path + ": live export segment from another version";
+    } else if (header->numberOfStates != cNumberOfOperationStates) {
+        error = path + ": live export segment from another version";
+    } else if (LiveSegmentLayout(header->numberOfModels).size > size) {
+        error = path + ": live export segment is too short";
+    } else {
+        segment = memory;
+        layout.reset(new LiveSegmentLayout(header->numberOfModels));
+        labels.clear();
+        for (size_t m = 0; m < layout->numberOfModels; ++m) {
+            const char* label = bytes + layout->labelsOffset + m * LiveSegmentLayout::cLabelSize;
+            labels.push_back(std::string(label, strnlen(label, LiveSegmentLayout::cLabelSize)));
+        }
+        sequence = reinterpret_cast<const std::atomic<uint64_t>*>(bytes + layout->sequenceOffset);
+        snapshot = reinterpret_cast<const std::atomic<uint64_t>*>(bytes + layout->snapshotOffset);
+        words.resize(layout->snapshotWords);
+        return true;
+    }
+    munmap(memory, size);
+    return false;
+}
+
+// Seqlock read: a copy is kept only if no store to the snapshot started or finished while it was made
+bool LiveReader::read(LiveSnapshot& copy, unsigned int maxTries) {
+    assert(segment);
+    for (unsigned int tries = 0; tries < maxTries; ++tries) {
+        uint64_t before = sequence->load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        for (size_t w = 0; w < words.size(); ++w) {
+            words[w] = snapshot[w].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence->load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+
+        copy.sequence = before;
+        copy.time = bitsDouble(words[cTime]);
+        copy.finished = words[cFinished] != 0;
+        copy.waiting = words[cWaiting];
+        copy.charging = words[cCharging];
+        copy.stateCounts.assign(words.begin() + cStateCounts, words.begin() + cStateCounts + cNumberOfOperationStates);
+        copy.modelTotals.resize(layout->numberOfModels);
+        const uint64_t* totals = words.data() + cStateCounts + cNumberOfOperationStates;
+        for (size_t m = 0; m < layout->numberOfModels; ++m) {
+            copy.modelTotals[m] = {bitsDouble(totals[3 * m]), bitsDouble(totals[3 * m + 1]),
+                                   bitsDouble(totals[3 * m + 2]), 0.0, 0};
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,140 @@
+#ifndef _LIVE_EXPORT_H
+#define _LIVE_EXPORT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./ChargingStation.h"
+#include "./FleetState.h"
+#include "./StationNetwork.h"
+#include "./Telemetry.h"
+#include "./Vehicle.h"
+
+using std::shared_ptr;
+using std::vector;
+
+// Live view of a running simulation for monitoring tools, in a POSIX shared memory segment.
+//
+// Every interval of world time the simulation publishes a snapshot: the number of vehicles in each
+// OperationState, the number of vehicles waiting for and using a charger and the per model totals so
+// far, the same sample as Telemetry. The snapshot is guarded by a seqlock: the publisher makes the
+// sequence number odd, stores the snapshot and makes it even again, and a reader copies the snapshot
+// and keeps the copy if the sequence number was the same even number before and after. Readers only
+// ever read the segment, so the publisher never waits for them and costs the same however many attach.
+//
+// The segment is native endian:
+//   header   - 8 byte "JOBYLIV" magic, uint32 version (stored last), number of states and number of models
+//   labels   - cLabelSize bytes per model, the label cut short and 0 padded
+//   sequence - uint64 on its own cache line, odd while a snapshot is being stored
+//   snapshot - 64 bit words: double time, uint64 1 once the run has finished, uint64 count per state,
+//              uint64 waiting, uint64 charging, per model double flight, charging and waiting minutes
+// It is removed when the run ends, readers that have it open keep the final snapshot.
+
+// A copy of the published snapshot
+struct LiveSnapshot {
+    uint64_t sequence;                // Even, twice the number of snapshots published so far
+    double time;                      // World time minutes
+    bool finished;                    // The run has ended and this is its final snapshot
+    vector<uint64_t> stateCounts;     // cNumberOfOperationStates entries
+    uint64_t waiting;
+    uint64_t charging;
+    vector<ModelTotals> modelTotals;  // Flight, charging and waiting minutes per model
+};
+
+// Shared memory segment layout, see above
+struct LiveSegmentLayout {
+    static const size_t cLabelSize = 32;
+    static const size_t cCacheLine = 64;
+
+    size_t numberOfModels;
+    size_t labelsOffset;
+    size_t sequenceOffset;
+    size_t snapshotOffset;
+    size_t snapshotWords;
+    size_t size;
+
+    explicit LiveSegmentLayout(size_t numberOfModels);
+};
+
+// Publishes snapshots of a tick or fleet engine run
+class LiveExport {
+private:
+    const double cInterval;
+    double nextPublishTime;
+    const std::string name;
+
+    // Model records in ModelIndex order, read by the Vehicle based publish()
+    vector<shared_ptr<ModelData>> models;
+    const LiveSegmentLayout layout;
+    void* segment;                          // Null if the segment couldn't be made
+    std::atomic<uint64_t>* sequence;
+    std::atomic<uint64_t>* snapshot;
+
+    // Sample scratch space, reused from one snapshot to the next
+    vector<uint64_t> stateCounts;
+    vector<ModelTotals> modelTotals;
+
+    void store(double time, bool finished, uint64_t waiting, uint64_t charging);
+
+public:
+    // Make the shared memory segment name ("/name", a leading / is added if missing), replacing any left
+    // from an earlier run. Check isOpen() before use.
+    LiveExport(const std::string& name, double interval, const vector<shared_ptr<ModelData>>& models);
+
+    // Publishes the final snapshot again marked finished and removes the segment
+    ~LiveExport();
+
+    // Prevent unneeded defaults
+    LiveExport(const LiveExport&) = delete;
+    LiveExport& operator=(const LiveExport&) = delete;
+
+    bool isOpen() const { return segment != nullptr; }
+    const std::string& getName() const { return name; }
+
+    // True when a snapshot should be published at world time
+    bool isDue(double time) const { return time >= nextPublishTime; }
+    double getNextPublishTime() const { return nextPublishTime; }
+
+    // Publish a snapshot of a fleet engine run
+    void publish(double time, const FleetState& fleet, const StationNetwork& stations);
+
+    // Publish a snapshot of a tick engine run, the model totals come from the shared ModelData records
+    void publish(double time, const vector<shared_ptr<Vehicle>>& vehicles, const ChargingStation& chargingStation);
+};
+
+// Reads the snapshots of a LiveExport from another process (or thread), see joby_monitor
+class LiveReader {
+private:
+    const void* segment;
+    size_t size;
+    std::unique_ptr<LiveSegmentLayout> layout;
+    vector<std::string> labels;
+    const std::atomic<uint64_t>* sequence;
+    const std::atomic<uint64_t>* snapshot;
+    vector<uint64_t> words;
+
+public:
+    LiveReader();
+    ~LiveReader();
+
+    // Prevent unneeded defaults
+    LiveReader(const LiveReader&) = delete;
+    LiveReader& operator=(const LiveReader&) = delete;
+
+    // Open the segment a LiveExport made with the same name. Returns false with a message in error if
+    // there is no segment by that name or it isn't a complete live export segment.
+    bool open(const std::string& name, std::string& error);
+    bool isOpen() const { return segment != nullptr; }
+
+    // Model labels in model index order
+    const vector<std::string>& getLabels() const { return labels; }
+
+    // Copy the latest snapshot. Tries again while a snapshot is being published, up to maxTries times,
+    // returns false if none of them got a consistent copy.
+    bool read(LiveSnapshot& copy, unsigned int maxTries = 1000);
+};
+
+#endif //_LIVE_EXPORT_H
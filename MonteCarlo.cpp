@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+#include "./MonteCarlo.h"
+#include "./FleetSimulation.h"
+#include "./RandomStream.h"
+#include "./Simulation.h"
+
+using std::cout;
+using std::unique_ptr;
+
+namespace {
+
+// Keeps the replication seeds apart from the draws made from the scenario seed itself
+const uint64_t cReplicationSeeds = 0xA0761D6478BD642FULL;
+
+// Everything one replication needs, reused from one replication to the next
+struct Replication {
+    VehicleModelMap modelStates;
+    FleetState fleet;
+    StationNetwork stations;
+    ThreadPool pool; // Single threaded, replications are the unit of parallel work
+    SessionStatistics sessions; // Every replication this one has run
+
+    Replication(const Scenario& scenario, const VehicleModelMap& models, const VertiportMap* vertiports) :
+            modelStates(models),
+            fleet(modelList(models)),
+            stations(scenario.numberOfStations, scenario.numberOfChargingSlots, scenario.fleetSize,
+                     makeRoutingPolicy(scenario.routing, scenario.numberOfStations, vertiports), scenario.battery),
+            pool(1),
+            sessions(models.size())
+    {
+        // Only model totals are sampled
+        fleet.keepVehicleTotals(false);
+        fleet.recordSessions(&sessions);
+        fleet.reserve(scenario.fleetSize);
+    }
+};
+
+// Percentile of sorted samples, interpolating between the closest ranks
+double percentile(const std::vector<double>& sorted, double fraction) {
+    double rank = fraction * (sorted.size() - 1);
+    size_t below = static_cast<size_t>(rank);
+    size_t above = std::min(below + 1, sorted.size() - 1);
+    return sorted[below] + (rank - below) * (sorted[above] - sorted[below]);
+}
+
+void printSummary(const char* name, const std::vector<double>& samples) {
+    SampleSummary summary = summarize(samples);
+    cout << name << summary.mean << " / " << summary.stddev << " / "
+         << summary.p5 << " / " << summary.p50 << " / " << summary.p95 << "\n";
+}
+
+}
+
+SampleSummary summarize(std::vector<double> samples) {
+    // Models that weren't in the fleet of a replication have no result for it
+    samples.erase(std::remove_if(samples.begin(), samples.end(), [](double x) { return std::isnan(x); }),
+                  samples.end());
+    if (samples.empty()) {
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        return {nan, nan, nan, nan, nan};
+    }
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (double x : samples) {
+        sum += x;
+    }
+    double mean = sum / samples.size();
+
+    double squares = 0.0;
+    for (double x : samples) {
+        squares += (x - mean) * (x - mean);
+    }
+    double stddev = samples.size() > 1 ? std::sqrt(squares / (samples.size() - 1)) : 0.0;
+
+    return {mean, stddev, percentile(samples, 0.05), percentile(samples, 0.5), percentile(samples, 0.95)};
+}
+
+unsigned long replicationSeed(unsigned long seed, unsigned int replication) {
+    return static_cast<unsigned long>(randomBits(seed ^ cReplicationSeeds, replication, 0));
+}
+
+std::vector<ModelSamples> runReplications(const Scenario& scenario, ThreadPool& pool,
+                                          SessionStatistics* sessions) {
+    VehicleModelMap models;
+    initializeModels(scenario, models);
+    // Every replication flies over the same map, shared read only between the threads
+    shared_ptr<const VertiportMap> vertiports = makeVertiportMap(scenario);
+
+    std::vector<ModelSamples> samples(scenario.models.size());
+    for (size_t m = 0; m < samples.size(); ++m) {
+        samples[m].label = scenario.models[m].label;
+        samples[m].averageFlightTime.resize(scenario.replications);
+        samples[m].averageWaitingTime.resize(scenario.replications);
+        samples[m].averageChargingTime.resize(scenario.replications);
+        samples[m].totalPassengerMiles.resize(scenario.replications);
+        samples[m].maxFaults.resize(scenario.replications);
+        samples[m].numberOfFaults.resize(scenario.replications);
+    }
+
+    // Replications that aren't running, at most one per thread is ever created
+    std::mutex idleMutex;
+    std::vector<unique_ptr<Replication>> idle;
+
+    pool.run(scenario.replications, [&](size_t r) {
+        unique_ptr<Replication> replication;
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            if (!idle.empty()) {
+                replication = std::move(idle.back());
+                idle.pop_back();
+            }
+        }
+        if (!replication) {
+            // Each replication gets its own copies of the model records
+            VehicleModelMap modelStates;
+            for (auto model : models) {
+                modelStates[model.first] = shared_ptr<ModelData>(new ModelData(*model.second));
+            }
+            replication.reset(new Replication(scenario, modelStates, vertiports.get()));
+        }
+
+        for (auto model : replication->modelStates) {
+            model.second->reset();
+        }
+        replication->fleet.clear();
+        replication->stations.reset();
+
+        unsigned long seed = replicationSeed(scenario.seed, static_cast<unsigned int>(r));
+        enableFleetModels(scenario, seed, replication->fleet, vertiports);
+        generateFleet(scenario.modelWeights, scenario.fleetSize, seed, replication->fleet);
+        runFleetLoop(replication->fleet, replication->stations, nullptr, scenario.increment,
+                     scenario.runTime, replication->pool);
+
+        for (auto model : replication->modelStates) {
+            const ModelData& data = *model.second;
+            ModelSamples& modelSamples = samples[model.first];
+            double fleetCount = data.fleetCount > 0 ? data.fleetCount : std::numeric_limits<double>::quiet_NaN();
+            modelSamples.averageFlightTime[r] = data.totalFlightTime / fleetCount;
+            modelSamples.averageWaitingTime[r] = data.totalWaitingTime / fleetCount;
+            modelSamples.averageChargingTime[r] = data.totalChargingTime / fleetCount;
+            modelSamples.totalPassengerMiles[r] =
+                    data.params.cruiseSpeed * (data.totalFlightTime / 60.0) * data.params.passengerCount;
+            modelSamples.maxFaults[r] = data.params.MaxFaultsPerHour * (data.totalFlightTime / 60.0);
+            modelSamples.numberOfFaults[r] = static_cast<double>(data.totalFaults);
+        }
+
+        std::lock_guard<std::mutex> lock(idleMutex);
+        idle.push_back(std::move(replication));
+    });
+
+    // Sketches merge the same in any order, so it doesn't matter which thread ran which replication
+    if (sessions) {
+        for (const unique_ptr<Replication>& replication : idle) {
+            sessions->merge(replication->sessions);
+        }
+    }
+    return samples;
+}
+
+void runMonteCarlo(const Scenario& scenario) {
+    ThreadPool pool(scenario.numberOfThreads);
+
+    double startTime = sysTime();
+    SessionStatistics sessions(scenario.models.size());
+    std::vector<ModelSamples> samples = runReplications(scenario, pool, &sessions);
+    double totalRunTime = sysTime() - startTime;
+
+    cout << "Monte Carlo finished, replications/threads/total-run-time(seconds): " << scenario.replications << "/"
+         << pool.size() << "/" << totalRunTime << "\n";
+    cout << "Seed: " << scenario.seed << "\n\n";
+
+    cout << "Per Model Stats (mean / stddev / p5 / p50 / p95):\n";
+    for (const ModelSamples& model : samples) {
+        cout << model.label << " Results: \n";
+        printSummary("   Average Time in Flight (mins): ", model.averageFlightTime);
+        printSummary("   Average Time Waiting (mins)  : ", model.averageWaitingTime);
+        printSummary("   Average Time Charging (mins) : ", model.averageChargingTime);
+        printSummary("   Max number of faults         : ", model.maxFaults);
+        if (scenario.faults) {
+            printSummary("   Number of faults             : ", model.numberOfFaults);
+        }
+        printSummary("   Total Passenger Miles        : ", model.totalPassengerMiles);
+    }
+    cout << "\n";
+    sessions.print(cout, scenario.models);
+    cout << std::flush;
+}
@@ -0,0 +1,53 @@
+#ifndef _MONTE_CARLO_H
+#define _MONTE_CARLO_H
+
+#include <string>
+#include <vector>
+
+#include "./Scenario.h"
+#include "./Statistics.h"
+#include "./ThreadPool.h"
+
+// Summary of one result across replications
+struct SampleSummary {
+    double mean;
+    double stddev;  // Sample standard deviation, 0 for a single sample
+    double p5;
+    double p50;
+    double p95;
+};
+
+// Summarize a set of samples, percentiles interpolate between the closest ranks
+SampleSummary summarize(std::vector<double> samples);
+
+// Per model results of every replication, indexed by replication
+struct ModelSamples {
+    std::string label;
+    std::vector<double> averageFlightTime;     // minutes per vehicle
+    std::vector<double> averageWaitingTime;    // minutes per vehicle
+    std::vector<double> averageChargingTime;   // minutes per vehicle
+    std::vector<double> totalPassengerMiles;
+    std::vector<double> maxFaults;
+    std::vector<double> numberOfFaults;        // Faults that happened, 0 unless scenario.faults
+};
+
+// Seed of a replication, a hash of the scenario seed and the replication number (see RandomStream.h),
+// so every replication is independent and can be rerun on its own
+unsigned long replicationSeed(unsigned long seed, unsigned int replication);
+
+// Run scenario.replications independent simulations of the scenario across the pool and collect the
+// ModelData results of each. Replications use the fleet engine with a fixed increment.
+//
+// Each thread of the pool keeps one fleet, model map and station network and reuses their memory from
+// one replication to the next. Results only depend on the seed of the replication, not on the pool.
+//
+// The waits and charging sessions of every replication are merged into sessions, if given.
+std::vector<ModelSamples> runReplications(const Scenario& scenario, ThreadPool& pool,
+                                          SessionStatistics* sessions = nullptr);
+
+// Run the replications of a scenario on scenario.numberOfThreads threads and print per model
+// mean, standard deviation and percentiles, then the distributions of the waits and charging sessions
+// of all the replications together.
+void runMonteCarlo(const Scenario& scenario);
+
+#endif //_MONTE_CARLO_H
@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+
+#include "./Pacer.h"
+
+using std::cout;
+
+Pacer::Pacer(double tickRate, double timeScale, unsigned int maxCatchUp) :
+        cTickRate(tickRate),
+        cIncrement(timeScale / tickRate),
+        cMaxCatchUp(std::max(maxCatchUp, 1u)),
+        startTime(0.0),
+        ticks(0),
+        steps(0),
+        overruns(0),
+        worstLag(0.0)
+{
+    assert(tickRate > 0.0);
+}
+
+double Pacer::now() {
+    struct timespec time_spec;
+    int status = clock_gettime(CLOCK_MONOTONIC, &time_spec);
+    assert(status == 0);
+    (void)status;
+    return time_spec.tv_sec + (time_spec.tv_nsec * 1e-9);
+}
+
+void Pacer::sleepUntil(double time) {
+    struct timespec deadline;
+    deadline.tv_sec = static_cast<time_t>(time);
+    deadline.tv_nsec = static_cast<long>((time - static_cast<double>(deadline.tv_sec)) * 1e9);
+    // Restart after signals, the deadline is absolute
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+}
+
+void Pacer::start() {
+    startTime = now();
+    ticks = 0;
+    steps = 0;
+    overruns = 0;
+    worstLag = 0.0;
+}
+
+double Pacer::next() {
+    // Due times are worked out from the start rather than the last tick so they don't drift
+    double due = startTime + static_cast<double>(ticks + 1) / cTickRate;
+    double time = now();
+    unsigned long stepTicks = 1;
+    if (time <= due) {
+        sleepUntil(due);
+    } else {
+        ++overruns;
+        worstLag = std::max(worstLag, time - due);
+        double dueTicks = std::floor((time - startTime) * cTickRate) - static_cast<double>(ticks);
+        stepTicks = static_cast<unsigned long>(std::min(std::max(dueTicks, 1.0), static_cast<double>(cMaxCatchUp)));
+    }
+    ticks += stepTicks;
+    ++steps;
+    return static_cast<double>(stepTicks) * cIncrement;
+}
+
+void Pacer::printReport() const {
+    cout << "Paced at " << cTickRate << " ticks/sec, " << cIncrement * cTickRate << " world min/sec: "
+         << ticks << " ticks in " << steps << " steps, " << overruns << " overruns";
+    if (overruns > 0) {
+        cout << " (worst " << worstLag * 1000.0 << " ms late)";
+    }
+    cout << "\n";
+}
@@ -0,0 +1,52 @@
+#ifndef _PACER_H
+#define _PACER_H
+
+// Paces a simulation loop against the wall clock for live runs.
+//
+// Ticks are due at a fixed rate and each one steps the world forward by the same amount, so a wall clock
+// second is always timeScale world minutes. The loop sleeps until the next tick is due instead of polling
+// the clock. A tick that is already due when the loop asks for it (the previous step ran long) is an
+// overrun: the loop isn't put to sleep and the step covers every tick that is due, up to maxCatchUp of
+// them, so it catches up with the wall clock in bounded steps.
+class Pacer {
+private:
+    const double cTickRate;          // Ticks per wall clock second
+    const double cIncrement;         // World minutes per tick
+    const unsigned int cMaxCatchUp;  // Most ticks a single step covers
+
+    double startTime;                // Wall clock seconds at start()
+    unsigned long ticks;             // Ticks stepped since start()
+
+    unsigned long steps;
+    unsigned long overruns;
+    double worstLag;                 // Wall clock seconds the latest tick was overdue by
+
+    // Wall clock seconds on the clock the pacer sleeps on
+    static double now();
+    static void sleepUntil(double time);
+
+public:
+    // tickRate ticks per wall clock second, timeScale world minutes per wall clock second
+    Pacer(double tickRate, double timeScale, unsigned int maxCatchUp);
+
+    // Disable unneeded defaults
+    Pacer(const Pacer&) = delete;
+    Pacer& operator=(const Pacer&) = delete;
+
+    // Start the clock, the first tick is due one tick from now
+    void start();
+
+    // Wait for the next tick to be due, returns the world minutes to step
+    double next();
+
+    double getIncrement() const { return cIncrement; }
+    unsigned long getTicks() const { return ticks; }
+    unsigned long getSteps() const { return steps; }
+    unsigned long getOverruns() const { return overruns; }
+    double getWorstLag() const { return worstLag; }
+
+    // Print the ticks, steps and overruns of the run
+    void printReport() const;
+};
+
+#endif //_PACER_H
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+#include "./Profiler.h"
+
+namespace {
+
+const char* const cPhaseNames[cNumberOfProfilePhases] = {
+        "simulation_pass", "vehicle_iteration", "landing_shuffle", "station_handoff", "station_iteration",
+        "fast_forward", "demand_dispatch", "telemetry_sample", "live_publish"};
+
+}
+
+const char* profilePhaseName(ProfilePhase phase) {
+    return cPhaseNames[phase];
+}
+
+std::atomic<Profiler*> Profiler::activeProfiler(nullptr);
+
+Profiler::Profiler(const vector<shared_ptr<ModelData>>& models, bool trace) :
+        transitions(new std::atomic<uint64_t>[models.size() * cNumberOfOperationStates * cNumberOfOperationStates]),
+        origin(std::chrono::steady_clock::now()),
+        tracing(trace),
+        droppedEvents(0)
+{
+    for (const shared_ptr<ModelData>& model : models) {
+        this->models.push_back(model.get());
+    }
+    for (size_t i = 0; i < models.size() * cNumberOfOperationStates * cNumberOfOperationStates; ++i) {
+        transitions[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+Profiler::~Profiler() {
+    Profiler* self = this;
+    activeProfiler.compare_exchange_strong(self, nullptr);
+}
+
+void Profiler::activate() {
+    activeProfiler.store(this);
+}
+
+void Profiler::deactivate() {
+    activeProfiler.store(nullptr);
+}
+
+uint64_t Profiler::now() const {
+    return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count());
+}
+
+void Profiler::recordPhase(ProfilePhase phase, uint64_t start, uint64_t end) {
+    phases[phase].record(end - start);
+    if (!tracing) {
+        return;
+    }
+    if (traceEvents.size() < cMaxTraceEvents) {
+        traceEvents.push_back(TraceEvent{start, end - start, phase});
+    } else {
+        ++droppedEvents;
+    }
+}
+
+size_t Profiler::transitionIndex(size_t model, unsigned int from, unsigned int to) const {
+    return (model * cNumberOfOperationStates + from) * cNumberOfOperationStates + to;
+}
+
+void Profiler::countTransition(const ModelData* model, unsigned int from, unsigned int to) {
+    // A handful of models, a linear search is quicker than anything cleverer
+    for (size_t m = 0; m < models.size(); ++m) {
+        if (models[m] == model) {
+            transitions[transitionIndex(m, from, to)].fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+uint64_t Profiler::getTransitions(size_t model, OperationState from, OperationState to) const {
+    return transitions[transitionIndex(model, from, to)].load(std::memory_order_relaxed);
+}
+
+void Profiler::printSummary(std::ostream& out) const {
+    const double cMicrosecond = 1e3;
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "Profile, phase: count/mean/p50/p90/p99/p99.9/max(microseconds)/total(seconds)\n";
+    for (unsigned int p = 0; p < cNumberOfProfilePhases; ++p) {
+        const LatencyHistogram& phase = phases[p];
+        if (phase.getCount() == 0) {
+            continue;
+        }
+        out << "  " << cPhaseNames[p] << ": " << phase.getCount() << "/" << phase.getMean() / cMicrosecond
+            << "/" << phase.percentile(0.5) / cMicrosecond << "/" << phase.percentile(0.9) / cMicrosecond
+            << "/" << phase.percentile(0.99) / cMicrosecond << "/" << phase.percentile(0.999) / cMicrosecond
+            << "/" << phase.getMaximum() / cMicrosecond << "/" << phase.getTotal() * 1e-9 << "\n";
+    }
+    if (droppedEvents > 0) {
+        out << "  trace full, " << droppedEvents << " phases not traced\n";
+    }
+
+    out << "Profile, state transitions per model:\n";
+    for (size_t m = 0; m < models.size(); ++m) {
+        out << "  " << models[m]->params.label << ":";
+        bool any = false;
+        for (unsigned int from = 0; from < cNumberOfOperationStates; ++from) {
+            for (unsigned int to = 0; to < cNumberOfOperationStates; ++to) {
+                uint64_t n = transitions[transitionIndex(m, from, to)].load(std::memory_order_relaxed);
+                if (n > 0) {
+                    out << " " << operationStateName(from) << "->" << operationStateName(to) << "=" << n;
+                    any = true;
+                }
+            }
+        }
+        out << (any ? "\n" : " none\n");
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool Profiler::writeTrace(const std::string& path, std::string& error) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        error = path + ": can't open trace file";
+        return false;
+    }
+
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    char event[160];
+    for (size_t e = 0; e < traceEvents.size(); ++e) {
+        const TraceEvent& trace = traceEvents[e];
+        int length = std::snprintf(event, sizeof(event),
+                                   "%s\n{\"name\":\"%s\",\"cat\":\"simulation\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                                   "\"pid\":1,\"tid\":1}",
+                                   e == 0 ? "" : ",", cPhaseNames[trace.phase], trace.start * 1e-3,
+                                   trace.duration * 1e-3);
+        file.write(event, length);
+    }
+    file << "\n]}\n";
+
+    file.close();
+    if (file.fail()) {
+        error = path + ": can't write trace file";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,163 @@
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "./Histogram.h"
+#include "./Vehicle.h"
+
+using std::shared_ptr;
+using std::vector;
+
+// Hot path profiling of the simulation loops.
+//
+// The loops are marked up with PROFILE_PHASE() and the vehicles with PROFILE_TRANSITION(). Both expand to
+// nothing unless the build defines JOBY_PROFILE (cmake -DJOBY_PROFILE=ON), so a normal build pays nothing
+// for them. A profiling build times every phase of every pass into a LatencyHistogram, counts the state
+// changes of each model and can keep a Chrome trace of the run (see Profiler::writeTrace()).
+
+#ifdef JOBY_PROFILE
+const bool cProfilingBuild = true;
+#else
+const bool cProfilingBuild = false;
+#endif
+
+// The timed parts of a pass over the fleet
+enum ProfilePhase {
+    simulation_pass,    // A whole pass, the phases below plus the loop's own work
+    vehicle_iteration,  // Iterating every vehicle (FleetState::iterate() for the fleet engine)
+    landing_shuffle,    // Shuffling the vehicles that landed on the pass, tick engine only
+    station_handoff,    // Handing landed and charged vehicles to the charging stations
+    station_iteration,  // ChargingStation::iterate() or StationNetwork::iterate()
+    fast_forward,       // Jumping over passes without state changes, tick engine only
+    demand_dispatch,    // Waking parked vehicles for trip requests, fleet engine with demand only
+    telemetry_sample,   // Recording a telemetry sample
+    live_publish,       // Publishing a live export snapshot
+};
+const unsigned int cNumberOfProfilePhases = ProfilePhase::live_publish + 1;
+
+// Name of a phase as shown in the summary and the trace
+const char* profilePhaseName(ProfilePhase phase);
+
+// Collects the profile of one simulation run. runSimulation() makes one and activates it for the length
+// of the run, the PROFILE_ macros record into whichever profiler is active and do nothing when none is.
+//
+// Phases must be recorded on the thread that activated the profiler, the loops time their phases there.
+// Transitions can be counted from any thread (the fleet engine counts them on its pool), the counters are
+// atomic.
+class Profiler {
+private:
+    static std::atomic<Profiler*> activeProfiler;
+
+    // Model records the transitions are counted for, same order as the simulation's model list
+    vector<const ModelData*> models;
+
+    LatencyHistogram phases[cNumberOfProfilePhases];
+
+    // Transition counts, indexed by (model * states + from) * states + to
+    std::unique_ptr<std::atomic<uint64_t>[]> transitions;
+
+    std::chrono::steady_clock::time_point origin;
+
+    // One Chrome trace "complete" event per recorded phase
+    struct TraceEvent {
+        uint64_t start;     // Nanoseconds since the profiler was made
+        uint64_t duration;
+        ProfilePhase phase;
+    };
+    bool tracing;
+    vector<TraceEvent> traceEvents;
+    uint64_t droppedEvents;
+
+    size_t transitionIndex(size_t model, unsigned int from, unsigned int to) const;
+
+public:
+    // Most trace events kept, about 24MB of them. Later phases are still timed, just not traced.
+    static const size_t cMaxTraceEvents = size_t(1) << 20;
+
+    // trace keeps an event for every recorded phase for writeTrace()
+    Profiler(const vector<shared_ptr<ModelData>>& models, bool trace);
+
+    // Deactivates the profiler if it is active
+    ~Profiler();
+
+    // Prevent unneeded defaults
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // Make this the profiler the PROFILE_ macros record into, until deactivate()
+    void activate();
+    static void deactivate();
+    static Profiler* active() { return activeProfiler.load(std::memory_order_relaxed); }
+
+    // Nanoseconds since the profiler was made
+    uint64_t now() const;
+
+    void recordPhase(ProfilePhase phase, uint64_t start, uint64_t end);
+
+    // Count a change of state of a vehicle of the given model. Models the profiler wasn't made with are
+    // ignored.
+    void countTransition(const ModelData* model, unsigned int from, unsigned int to);
+
+    const LatencyHistogram& getPhase(ProfilePhase phase) const { return phases[phase]; }
+    uint64_t getTransitions(size_t model, OperationState from, OperationState to) const;
+    size_t getNumberOfTraceEvents() const { return traceEvents.size(); }
+
+    // Print the phase latencies and the transition counts of each model
+    void printSummary(std::ostream& out) const;
+
+    // Write the trace as Chrome trace event JSON (chrome://tracing or ui.perfetto.dev), one complete
+    // event per phase with its start and duration in microseconds. Returns false with a message in error
+    // if the file can't be written.
+    bool writeTrace(const std::string& path, std::string& error) const;
+};
+
+// Times a phase from construction to the end of the scope, if a profiler is active
+class ProfileScope {
+private:
+    Profiler* const profiler;
+    const ProfilePhase phase;
+    const uint64_t start;
+
+public:
+    explicit ProfileScope(ProfilePhase phase) :
+            profiler(Profiler::active()),
+            phase(phase),
+            start(profiler ? profiler->now() : 0)
+    {}
+
+    ~ProfileScope() {
+        if (profiler) {
+            profiler->recordPhase(phase, start, profiler->now());
+        }
+    }
+
+    // Prevent unneeded defaults
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#ifdef JOBY_PROFILE
+#define PROFILE_NAME_(line) profileScope##line
+#define PROFILE_NAME(line) PROFILE_NAME_(line)
+// Time the rest of the enclosing scope as the given ProfilePhase
+#define PROFILE_PHASE(phase) ProfileScope PROFILE_NAME(__LINE__)(ProfilePhase::phase)
+// Count a change of state of a vehicle, model is a const ModelData*
+#define PROFILE_TRANSITION(model, from, to) \
+    do { \
+        if (Profiler* profiler_ = Profiler::active()) { \
+            profiler_->countTransition(model, from, to); \
+        } \
+    } while (0)
+#else
+#define PROFILE_PHASE(phase) ((void)0)
+#define PROFILE_TRANSITION(model, from, to) ((void)0)
+#endif
+
+#endif //_PROFILER_H
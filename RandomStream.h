@@ -0,0 +1,68 @@
+#ifndef _RANDOM_STREAM_H
+#define _RANDOM_STREAM_H
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+// Counter based random numbers.
+//
+// Every draw is a hash of its key: a seed, a stream and the number of the draw in the stream. Nothing is
+// carried from one draw to the next, so any draw can be made on its own, in any order and on any thread,
+// and gets the same value. Streams are keyed by what they are for: a vehicle's draws use its index as
+// the stream (with a constant mixed into the seed for each kind of draw), a replication's draws are
+// made from its replicationSeed() (see MonteCarlo.h), so each (seed, replication, vehicle) has streams
+// of its own and results don't depend on the number of threads.
+//
+// The hash is the SplitMix64 finalizer over seed + golden ratio * (1 + stream + number << 32), which is
+// SplitMix64 itself for stream 0. A stream has 2^32 draws, see RandomStream for the ones that use many.
+
+// 64 random bits for draw number of stream in seed
+inline uint64_t randomBits(uint64_t seed, uint32_t stream, uint32_t number) {
+    uint64_t x = seed + 0x9E3779B97F4A7C15ULL * (1 + stream + (static_cast<uint64_t>(number) << 32));
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Uniform in [0, 1) from randomBits()
+inline double uniformDraw(uint64_t seed, uint32_t stream, uint32_t number) {
+    return static_cast<double>(randomBits(seed, stream, number) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// The draws of one stream in turn, for the places that take a sequence of draws: std::shuffle(), the
+// <random> distributions or arrival processes. Copying a stream copies its place in it.
+//
+// The draw number doesn't carry into the stream, so a stream ends after 2^32 draws: debug builds assert,
+// release builds would start it over. The busiest stream is the tick engine's landing shuffle, at about
+// a draw a landing, which a million vehicles landing every 40 minutes would use up in about 120 days of
+// world time.
+class RandomStream {
+private:
+    uint64_t seed;
+    uint32_t stream;
+    uint32_t number;    // Next draw
+
+    uint32_t next() {
+        assert(number != std::numeric_limits<uint32_t>::max() && "random stream used up");
+        return number++;
+    }
+
+public:
+    typedef uint64_t result_type;
+
+    explicit RandomStream(uint64_t seed, uint32_t stream = 0) : seed(seed), stream(stream), number(0) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() { return randomBits(seed, stream, next()); }
+
+    // Uniform in [0, 1)
+    double uniform() { return uniformDraw(seed, stream, next()); }
+
+    // Number of draws made so far
+    uint32_t getCount() const { return number; }
+};
+
+#endif //_RANDOM_STREAM_H
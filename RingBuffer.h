@@ -0,0 +1,61 @@
+#ifndef _RING_BUFFER_H
+#define _RING_BUFFER_H
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// Fixed capacity FIFO queue. All storage is allocated on construction, push and pop
+// never allocate.
+template <typename T>
+class RingBuffer {
+private:
+    std::vector<T> items;
+    size_t head;   // Index of the front item
+    size_t count;
+
+public:
+    explicit RingBuffer(size_t capacity) : items(capacity), head(0), count(0) {}
+
+    // Disable unneeded defaults
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    size_t capacity() const { return items.size(); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == items.size(); }
+
+    // Add to the back, the buffer must not be full
+    void push(const T& item) {
+        assert(!full());
+        size_t tail = head + count;
+        if (tail >= items.size()) {
+            tail -= items.size();
+        }
+        items[tail] = item;
+        ++count;
+    }
+
+    // The front item, the buffer must not be empty
+    const T& front() const {
+        assert(!empty());
+        return items[head];
+    }
+
+    // Remove the front item, the buffer must not be empty
+    void pop() {
+        assert(!empty());
+        if (++head == items.size()) {
+            head = 0;
+        }
+        --count;
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+};
+
+#endif //_RING_BUFFER_H
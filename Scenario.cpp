@@ -0,0 +1,595 @@
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+
+#include "./Scenario.h"
+
+namespace {
+
+// Fields of a [model ...] section while it is being read
+struct ModelFields {
+    std::string label;
+    double cruiseSpeed;
+    double batteryCapacity;
+    double timeToCharge;
+    double energyUseAtCruise;
+    double passengerCount;
+    double maxFaultsPerHour;
+    double endurance;
+    double weight;
+};
+
+const double cMissing = -1.0;
+
+ModelFields newModel(const std::string& label) {
+    return {label, cMissing, cMissing, cMissing, cMissing, cMissing, cMissing, cMissing, 1.0};
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool parseNumber(const std::string& text, double& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end;
+    errno = 0;
+    value = std::strtod(text.c_str(), &end);
+    return errno == 0 && *end == '\0';
+}
+
+bool parseCount(const std::string& text, unsigned long& value) {
+    if (text.empty() || text[0] == '-') {
+        return false;
+    }
+    char* end;
+    errno = 0;
+    value = std::strtoul(text.c_str(), &end, 10);
+    return errno == 0 && *end == '\0';
+}
+
+// A count setting of at least minimum, up to maximum, the most its scenario field can hold
+bool parseCountSetting(const std::string& key, const std::string& value, unsigned long minimum,
+                       unsigned long maximum, unsigned long& count, std::string& error) {
+    if (!parseCount(value, count) || count < minimum) {
+        error = "bad " + key + ": " + value;
+        return false;
+    }
+    if (count > maximum) {
+        error = key + " can't be over " + std::to_string(maximum) + ": " + value;
+        return false;
+    }
+    return true;
+}
+
+// Most values a count list can expand to, each one is a run of a sweep
+const size_t cMaxListValues = 10000;
+
+// Comma separated counts up to maximum and first:last[:step] ranges, e.g. "1:4,8,16"
+bool parseCountList(const std::string& text, unsigned long maximum, std::vector<unsigned int>& values) {
+    values.clear();
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        std::vector<unsigned long> bounds;
+        std::stringstream parts(trim(item));
+        std::string part;
+        while (std::getline(parts, part, ':')) {
+            unsigned long bound;
+            if (!parseCount(trim(part), bound) || bound > maximum) {
+                return false;
+            }
+            bounds.push_back(bound);
+        }
+        if (bounds.empty() || bounds.size() > 3 || (bounds.size() == 3 && bounds[2] == 0)) {
+            return false;
+        }
+        unsigned long last = bounds.size() > 1 ? bounds[1] : bounds[0];
+        unsigned long step = bounds.size() > 2 ? bounds[2] : 1;
+        if (last >= bounds[0] && (last - bounds[0]) / step >= cMaxListValues - values.size()) {
+            return false;
+        }
+        for (unsigned long value = bounds[0]; value <= last; value += step) {
+            values.push_back(static_cast<unsigned int>(value));
+        }
+    }
+    return !values.empty();
+}
+
+// Comma separated sets of space separated weights, e.g. "1 1 2, 4 1 1"
+bool parseWeightList(const std::string& text, std::vector<std::vector<double>>& values) {
+    values.clear();
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        std::vector<double> weights;
+        std::stringstream parts(item);
+        std::string part;
+        double totalWeight = 0.0;
+        while (parts >> part) {
+            double weight;
+            if (!parseNumber(part, weight) || weight < 0.0) {
+                return false;
+            }
+            weights.push_back(weight);
+            totalWeight += weight;
+        }
+        if (totalWeight <= 0.0) {
+            return false;
+        }
+        values.push_back(weights);
+    }
+    return !values.empty();
+}
+
+bool setModelField(ModelFields& model, const std::string& key, const std::string& value, std::string& error) {
+    double number;
+    if (!parseNumber(value, number) || number < 0.0) {
+        error = "bad value for " + key + ": " + value;
+        return false;
+    }
+    if (key == "cruise_speed") {
+        model.cruiseSpeed = number;
+    } else if (key == "battery_capacity") {
+        model.batteryCapacity = number;
+    } else if (key == "time_to_charge") {
+        model.timeToCharge = number;
+    } else if (key == "energy_use") {
+        model.energyUseAtCruise = number;
+    } else if (key == "passengers") {
+        model.passengerCount = number;
+    } else if (key == "faults_per_hour") {
+        model.maxFaultsPerHour = number;
+    } else if (key == "endurance") {
+        model.endurance = number;
+    } else if (key == "weight") {
+        model.weight = number;
+    } else {
+        error = "unknown model setting " + key;
+        return false;
+    }
+    return true;
+}
+
+// Check a finished [model ...] section and add it to the scenario. Flights and charges have to take some
+// time, or the engines would go round the same instant forever.
+bool addModel(Scenario& scenario, const ModelFields& model, std::string& error) {
+    if (model.cruiseSpeed <= 0.0 || model.batteryCapacity <= 0.0 || model.timeToCharge <= 0.0 ||
+        model.energyUseAtCruise <= 0.0 || model.passengerCount < 0.0 || model.maxFaultsPerHour < 0.0) {
+        error = "model " + model.label + " needs cruise_speed, battery_capacity, time_to_charge, energy_use, "
+                "passengers and faults_per_hour";
+        return false;
+    }
+    if (model.endurance == 0.0) {
+        error = "model " + model.label + " needs an endurance above 0";
+        return false;
+    }
+    double endurance = model.endurance;
+    if (endurance < 0.0) {
+        endurance = (model.batteryCapacity * 60.0) / (model.cruiseSpeed * model.energyUseAtCruise);
+    }
+    scenario.models.push_back({
+        model.label,
+        model.cruiseSpeed,
+        model.batteryCapacity,
+        model.timeToCharge,
+        model.energyUseAtCruise,
+        static_cast<unsigned int>(model.passengerCount),
+        model.maxFaultsPerHour,
+        endurance
+    });
+    scenario.modelWeights.push_back(model.weight);
+    return true;
+}
+
+}
+
+Scenario defaultScenario() {
+    Scenario scenario;
+    // Define the specific Models
+    scenario.models = std::vector<ModelParameters>{
+        {
+            "Alpha",
+            120.0,       // Speed (mph)
+            320.0,       // Battery Capacity (kWh)
+            0.6 * 60.0,  // Time to Charge (minutes)
+            1.6,         // Energy use at Cruse (kwh/mile)
+            4,           // Passenger Count
+            0.25,        // Fault probability / hour
+            (320.0 * 60.0) / (120.0 * 1.6) // Flight endurance (minutes), I could calculate this every time.
+        },
+        {
+            "Beta",
+            100.0,       // Speed (mph)
+            100.0,       // Battery Capacity (kWh)
+            0.2 * 60.0,  // Time to Charge (minutes)
+            1.5,         // Energy use at Cruse (kwh/mile)
+            5,           // Passenger Count
+            0.1,         // Fault probability / hour
+            (100.0 * 60.0) / (100.0 * 1.5) // Flight endurance (minutes), I could calculate this every time.
+        },
+        {
+            "Charlie",
+            160.0,       // Speed (mph)
+            220.0,       // Battery Capacity (kWh)
+            0.8 * 60.0,  // Time to Charge (minutes)
+            2.2,         // Energy use at Cruse (kwh/mile)
+            3,           // Passenger Count
+            0.05,        // Fault probability / hour
+            (220.0 * 60.0) / (160.0 * 2.2) // Flight endurance (minutes), I could calculate this every time.
+        },
+        {
+            "Delta",
+            90.0,       // Speed (mph)
+            120.0,       // Battery Capacity (kWh)
+            0.62 * 60.0,  // Time to Charge (minutes)
+            0.8,         // Energy use at Cruse (kwh/mile)
+            2,           // Passenger Count
+            0.22,        // Fault probability / hour
+            (120.0 * 60.0) / (120.0 * 1.6) // Flight endurance (minutes), I could calculate this every time.
+        },
+        {
+            "Echo",
+            30.0,        // Speed (mph)
+            150.0,       // Battery Capacity (kWh)
+            0.3 * 60.0,  // Time to Charge (minutes)
+            5.8,         // Energy use at Cruse (kwh/mile)
+            2,           // Passenger Count
+            0.61,        // Fault probability / hour
+            (150.0 * 60.0) / (30.0 * 5.8) // Flight endurance (minutes), I could calculate this every time.
+        },
+    };
+    // Models are equally likely
+    scenario.modelWeights.assign(scenario.models.size(), 1.0);
+
+    scenario.fleetSize = 20;
+    scenario.vehicleResults = true;
+    // Assumption: There is only one charging location that all vehicles share after every trip.
+    scenario.numberOfChargingSlots = 3;
+    scenario.numberOfStations = 1;
+    scenario.routing = StationRouting::nearest_routing;
+    scenario.numberOfVertiports = 0;
+    scenario.vertiportArea = 50.0;
+    scenario.runTime = 60.0 * 3.0; // 180 minutes or 3 hours world time
+    scenario.useRealTime = true;
+    scenario.tickRate = 100.0;
+    scenario.timeScale = 1.0;
+    scenario.maxCatchUp = 10;
+    scenario.increment = 0.01;
+    scenario.engine = SimulationEngine::tick_engine;
+    scenario.fastForward = true;
+    scenario.numberOfThreads = 1;
+
+    std::random_device rd;
+    scenario.seed = rd();
+    scenario.replications = 1;
+    scenario.faults = false;
+    scenario.maintenanceTime = 60.0;
+    scenario.battery = false;
+    scenario.minimumTripTime = std::numeric_limits<double>::infinity();
+    scenario.maximumTripTime = std::numeric_limits<double>::infinity();
+    scenario.chargeTo = 1.0;
+    scenario.telemetryInterval = 1.0;
+    scenario.liveInterval = 1.0;
+    scenario.checkpointTime = std::numeric_limits<double>::infinity();
+    scenario.sweepMaxWait = std::numeric_limits<double>::infinity();
+    return scenario;
+}
+
+bool applySetting(Scenario& scenario, const std::string& key, const std::string& value, std::string& error) {
+    double number;
+    unsigned long count;
+    if (key == "duration") {
+        if (!parseNumber(value, number) || number < 0.0) {
+            error = "bad duration: " + value;
+            return false;
+        }
+        scenario.runTime = number;
+    } else if (key == "step") {
+        if (value != "clock" && value != "fixed") {
+            error = "step must be clock or fixed: " + value;
+            return false;
+        }
+        scenario.useRealTime = value == "clock";
+    } else if (key == "tick_rate") {
+        if (!parseNumber(value, number) || number <= 0.0) {
+            error = "bad tick_rate: " + value;
+            return false;
+        }
+        scenario.tickRate = number;
+    } else if (key == "time_scale") {
+        if (!parseNumber(value, number) || number <= 0.0) {
+            error = "bad time_scale: " + value;
+            return false;
+        }
+        scenario.timeScale = number;
+    } else if (key == "max_catch_up") {
+        if (!parseCountSetting(key, value, 1, std::numeric_limits<unsigned int>::max(), count, error)) {
+            return false;
+        }
+        scenario.maxCatchUp = static_cast<unsigned int>(count);
+    } else if (key == "increment") {
+        if (!parseNumber(value, number) || number <= 0.0) {
+            error = "bad increment: " + value;
+            return false;
+        }
+        scenario.increment = number;
+    } else if (key == "engine") {
+        if (value == "tick") {
+            scenario.engine = SimulationEngine::tick_engine;
+        } else if (value == "event") {
+            scenario.engine = SimulationEngine::event_engine;
+        } else if (value == "fleet") {
+            scenario.engine = SimulationEngine::fleet_engine;
+        } else if (value == "static") {
+            scenario.engine = SimulationEngine::static_engine;
+        } else {
+            error = "engine must be tick, event, fleet or static: " + value;
+            return false;
+        }
+    } else if (key == "threads") {
+        if (!parseCountSetting(key, value, 0, std::numeric_limits<unsigned int>::max(), count, error)) {
+            return false;
+        }
+        scenario.numberOfThreads = static_cast<unsigned int>(count);
+    } else if (key == "seed") {
+        if (!parseCount(value, count)) {
+            error = "bad seed: " + value;
+            return false;
+        }
+        scenario.seed = count;
+    } else if (key == "replications") {
+        if (!parseCountSetting(key, value, 1, std::numeric_limits<unsigned int>::max(), count, error)) {
+            return false;
+        }
+        scenario.replications = static_cast<unsigned int>(count);
+    } else if (key == "fleet_size") {
+        if (!parseCountSetting(key, value, 0, std::numeric_limits<unsigned int>::max(), count, error)) {
+            return false;
+        }
+        scenario.fleetSize = static_cast<unsigned int>(count);
+    } else if (key == "chargers") {
+        if (!parseCountSetting(key, value, 0, std::numeric_limits<int>::max(), count, error)) {
+            return false;
+        }
+        scenario.numberOfChargingSlots = static_cast<int>(count);
+    } else if (key == "fast_forward") {
+        if (value != "on" && value != "off") {
+            error = "fast_forward must be on or off: " + value;
+            return false;
+        }
+        scenario.fastForward = value == "on";
+    } else if (key == "vehicle_results") {
+        if (value != "on" && value != "off") {
+            error = "vehicle_results must be on or off: " + value;
+            return false;
+        }
+        scenario.vehicleResults = value == "on";
+    } else if (key == "faults") {
+        if (value != "on" && value != "off") {
+            error = "faults must be on or off: " + value;
+            return false;
+        }
+        scenario.faults = value == "on";
+    } else if (key == "maintenance_time") {
+        if (!parseNumber(value, number) || number < 0.0) {
+            error = "bad maintenance_time: " + value;
+            return false;
+        }
+        scenario.maintenanceTime = number;
+    } else if (key == "battery") {
+        if (value != "on" && value != "off") {
+            error = "battery must be on or off: " + value;
+            return false;
+        }
+        scenario.battery = value == "on";
+    } else if (key == "trip_time") {
+        // A single time or a shortest:longest range
+        size_t colon = value.find(':');
+        double longest = 0.0;
+        if (!parseNumber(value.substr(0, colon), number) ||
+            !parseNumber(colon == std::string::npos ? value : value.substr(colon + 1), longest) ||
+            number <= 0.0 || longest < number) {
+            error = "bad trip_time: " + value;
+            return false;
+        }
+        scenario.minimumTripTime = number;
+        scenario.maximumTripTime = longest;
+    } else if (key == "charge_to") {
+        if (!parseNumber(value, number) || number <= 0.0 || number > 1.0) {
+            error = "charge_to must be a fraction in (0, 1]: " + value;
+            return false;
+        }
+        scenario.chargeTo = number;
+    } else if (key == "telemetry") {
+        scenario.telemetryPath = value;
+    } else if (key == "telemetry_interval") {
+        if (!parseNumber(value, number) || number <= 0.0) {
+            error = "bad telemetry_interval: " + value;
+            return false;
+        }
+        scenario.telemetryInterval = number;
+    } else if (key == "checkpoint") {
+        scenario.checkpointPath = value;
+    } else if (key == "checkpoint_at") {
+        if (!parseNumber(value, number) || number < 0.0) {
+            error = "bad checkpoint_at: " + value;
+            return false;
+        }
+        scenario.checkpointTime = number;
+    } else if (key == "restore") {
+        scenario.restorePath = value;
+    } else if (key == "profile_trace") {
+        scenario.profileTracePath = value;
+    } else if (key == "demand") {
+        scenario.demandPath = value;
+    } else if (key == "live") {
+        scenario.liveName = value;
+    } else if (key == "live_interval") {
+        if (!parseNumber(value, number) || number <= 0.0) {
+            error = "bad live_interval: " + value;
+            return false;
+        }
+        scenario.liveInterval = number;
+    } else if (key == "sweep_chargers") {
+        if (!parseCountList(value, std::numeric_limits<int>::max(), scenario.sweepChargers)) {
+            error = "bad sweep_chargers: " + value;
+            return false;
+        }
+    } else if (key == "sweep_fleet_size") {
+        if (!parseCountList(value, std::numeric_limits<unsigned int>::max(), scenario.sweepFleetSizes)) {
+            error = "bad sweep_fleet_size: " + value;
+            return false;
+        }
+    } else if (key == "sweep_weights") {
+        if (!parseWeightList(value, scenario.sweepWeights)) {
+            error = "bad sweep_weights: " + value;
+            return false;
+        }
+    } else if (key == "sweep_max_wait") {
+        if (!parseNumber(value, number) || number < 0.0) {
+            error = "bad sweep_max_wait: " + value;
+            return false;
+        }
+        scenario.sweepMaxWait = number;
+    } else if (key == "sweep_output") {
+        scenario.sweepOutput = value;
+    } else if (key == "stations") {
+        if (!parseCountSetting(key, value, 1, std::numeric_limits<unsigned int>::max(), count, error)) {
+            return false;
+        }
+        scenario.numberOfStations = static_cast<unsigned int>(count);
+    } else if (key == "routing") {
+        if (value == "nearest") {
+            scenario.routing = StationRouting::nearest_routing;
+        } else if (value == "least_queued") {
+            scenario.routing = StationRouting::least_queued_routing;
+        } else if (value == "round_robin") {
+            scenario.routing = StationRouting::round_robin_routing;
+        } else {
+            error = "routing must be nearest, least_queued or round_robin: " + value;
+            return false;
+        }
+    } else if (key == "vertiports") {
+        if (!parseCount(value, count) || count == 1 || count > std::numeric_limits<unsigned int>::max()) {
+            error = "vertiports must be 0 or at least 2: " + value;
+            return false;
+        }
+        scenario.numberOfVertiports = static_cast<unsigned int>(count);
+    } else if (key == "vertiport_area") {
+        if (!parseNumber(value, number) || number <= 0.0) {
+            error = "bad vertiport_area: " + value;
+            return false;
+        }
+        scenario.vertiportArea = number;
+    } else {
+        error = "unknown setting " + key;
+        return false;
+    }
+    return true;
+}
+
+bool loadScenario(const std::string& path, Scenario& scenario, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = path + ": can't open";
+        return false;
+    }
+
+    // Read the whole file at once, getline on the stream is slow for big model sets
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    enum { none, simulation, model } section = none;
+    ModelFields currentModel = newModel("");
+    bool replacedModels = false;
+
+    std::string line;
+    unsigned int lineNumber = 0;
+    std::string reason;
+    while (std::getline(contents, line)) {
+        ++lineNumber;
+        line = trim(line.substr(0, line.find_first_of(";#")));
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line[0] == '[') {
+            if (line.back() != ']') {
+                error = path + ":" + std::to_string(lineNumber) + ": bad section header";
+                return false;
+            }
+            if (section == model && !addModel(scenario, currentModel, reason)) {
+                error = path + ":" + std::to_string(lineNumber) + ": " + reason;
+                return false;
+            }
+
+            std::string name = trim(line.substr(1, line.size() - 2));
+            if (name == "simulation") {
+                section = simulation;
+            } else if (name.compare(0, 6, "model ") == 0 && !trim(name.substr(6)).empty()) {
+                // The first model in the file replaces the built in models
+                if (!replacedModels) {
+                    scenario.models.clear();
+                    scenario.modelWeights.clear();
+                    replacedModels = true;
+                }
+                section = model;
+                currentModel = newModel(trim(name.substr(6)));
+            } else {
+                error = path + ":" + std::to_string(lineNumber) + ": unknown section " + name;
+                return false;
+            }
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            error = path + ":" + std::to_string(lineNumber) + ": expected key = value";
+            return false;
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+
+        bool ok;
+        if (section == simulation) {
+            ok = applySetting(scenario, key, value, reason);
+        } else if (section == model) {
+            ok = setModelField(currentModel, key, value, reason);
+        } else {
+            ok = false;
+            reason = "setting outside of a section";
+        }
+        if (!ok) {
+            error = path + ":" + std::to_string(lineNumber) + ": " + reason;
+            return false;
+        }
+    }
+
+    if (section == model && !addModel(scenario, currentModel, reason)) {
+        error = path + ":" + std::to_string(lineNumber) + ": " + reason;
+        return false;
+    }
+    double totalWeight = 0.0;
+    for (double weight : scenario.modelWeights) {
+        totalWeight += weight;
+    }
+    if (scenario.models.empty() || totalWeight <= 0.0) {
+        error = path + ": no models with a weight above 0";
+        return false;
+    }
+    if (scenario.models.size() > 65536) {
+        error = path + ": more than 65536 models";
+        return false;
+    }
+    return true;
+}
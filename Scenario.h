@@ -0,0 +1,145 @@
+#ifndef _SCENARIO_H
+#define _SCENARIO_H
+
+#include <string>
+#include <vector>
+
+#include "./Vehicle.h"
+
+// The engines the simulation can be run with
+enum SimulationEngine {
+    tick_engine,   // Every vehicle is iterated on every (fixed or clock based) increment
+    event_engine,  // Vehicles are only touched when they change state (see EventSimulation.h)
+    fleet_engine,  // Same as tick_engine over a structure-of-arrays fleet (see FleetState.h)
+    static_engine, // fleet_engine for the built in models, specialized for them at build time (see StaticFleet.h)
+};
+
+// How a landed vehicle picks a charging station when there is more than one (see StationNetwork.h)
+enum StationRouting {
+    nearest_routing,       // The nearest station with vertiports, the vehicle's home station without
+    least_queued_routing,  // Fewest vehicles charging or waiting
+    round_robin_routing,   // Stations in turn
+};
+
+// Everything that describes a simulation run.
+//
+// defaultScenario() has the five eVTOL models and the settings main() used to hard-code. A scenario file
+// or command line overrides replace parts of it (see loadScenario() and applySetting()).
+struct Scenario {
+    // Vehicle models and their relative share of the fleet, in model index order
+    std::vector<ModelParameters> models;
+    std::vector<double> modelWeights;
+
+    unsigned int fleetSize;
+    bool vehicleResults;           // Print the results of every vehicle, fleet_engine only keeps per vehicle totals for this
+    int numberOfChargingSlots;     // Per station
+    unsigned int numberOfStations; // fleet_engine and replications only
+    StationRouting routing;
+    unsigned int numberOfVertiports; // Trips between vertiports, battery model only, 0 for none (see Geography.h)
+    double vertiportArea;          // Miles on a side of the square the vertiports are spread over
+    double runTime;                // World time minutes to run
+    bool useRealTime;              // Step in time with the wall clock (see Pacer.h) rather than by increment flat out
+    double tickRate;               // Steps per wall clock second when using the wall clock
+    double timeScale;              // World time minutes per wall clock second when using the wall clock
+    unsigned int maxCatchUp;       // Most ticks one step covers when catching up with the wall clock
+    double increment;              // World time minutes per step when not using the system clock
+    SimulationEngine engine;
+    bool fastForward;              // tick_engine with fixed steps only, jump over passes without state changes
+    unsigned int numberOfThreads;  // fleet_engine and replications only, 0 for one per core
+    unsigned long seed;            // Random number seed, drawn from std::random_device by default
+    unsigned int replications;     // Independent runs with seeds derived from seed (see MonteCarlo.h)
+    bool faults;                   // Simulate faults and maintenance, fleet_engine and replications only
+    double maintenanceTime;        // World time minutes a vehicle is grounded after a fault
+    bool battery;                  // Model state of charge and partial charges, fleet_engine and replications only
+    double minimumTripTime;        // Flight minutes of the shortest trip with the battery model
+    double maximumTripTime;        // Longest trip, infinite to fly until the battery is flat
+    double chargeTo;               // Fraction of a full battery a vehicle charges up to with the battery model
+    std::string telemetryPath;     // Time series output, tick and fleet engines only, empty for none (see Telemetry.h)
+    double telemetryInterval;      // World time minutes between telemetry samples
+    std::string checkpointPath;    // Checkpoint file to write, fleet_engine only, empty for none (see Checkpoint.h)
+    double checkpointTime;         // World time minutes to write the checkpoint at, infinite for the end of the run
+    std::string restorePath;       // Checkpoint file to continue a fleet_engine run from, empty for a new run
+    std::string profileTracePath;  // Chrome trace of a profiling build's run, empty for none (see Profiler.h)
+    std::string demandPath;        // Trip requests by time of day, fleet_engine only, empty to fly nonstop (see Demand.h)
+    std::string liveName;          // Shared memory segment for monitors, tick and fleet engines only, empty for none
+                                   // (see LiveExport.h)
+    double liveInterval;           // World time minutes between live snapshots
+
+    // Parameter sweep (see Sweep.h): a run for every combination of the values in these lists, an empty
+    // list keeps the single setting above
+    std::vector<unsigned int> sweepChargers;
+    std::vector<unsigned int> sweepFleetSizes;
+    std::vector<std::vector<double>> sweepWeights;  // Sets of model weights, one weight per model
+    double sweepMaxWait;           // Stop a run once its average wait per vehicle is past this, infinite for never
+    std::string sweepOutput;       // CSV file for the sweep results, empty for standard output
+};
+
+// The built in models and settings
+Scenario defaultScenario();
+
+// Load a scenario file into scenario. Settings that aren't in the file keep their current value, and
+// models in the file replace all current models. Returns false with a "file:line: reason" message in
+// error if the file can't be read or parsed.
+//
+// The file is INI style, ';' or '#' start comments:
+//
+//   [simulation]
+//   duration = 180          ; world time minutes
+//   step = clock            ; clock or fixed
+//   increment = 0.01        ; minutes per step when step = fixed
+//   tick_rate = 100         ; steps per wall clock second when step = clock
+//   time_scale = 1          ; world time minutes per wall clock second when step = clock
+//   max_catch_up = 10       ; most ticks one step covers after falling behind the wall clock
+//   engine = fleet          ; tick, event, fleet or static
+//   fast_forward = on       ; on or off, jump over passes without state changes (engine = tick, step = fixed)
+//   threads = 0
+//   seed = 42
+//   replications = 1000     ; more than 1 runs a Monte Carlo batch
+//   fleet_size = 1000000
+//   vehicle_results = off   ; on or off, print the results of every vehicle as well as every model
+//   chargers = 3            ; slots per station
+//   stations = 1            ; more than 1 needs engine = fleet
+//   routing = nearest       ; nearest, least_queued or round_robin
+//   vertiports = 10000      ; fly trips between vertiports, the first ones have the stations (battery = on)
+//   vertiport_area = 50     ; miles on a side of the square they are spread over
+//   faults = on             ; on or off, simulate faults from faults_per_hour (engine = fleet)
+//   maintenance_time = 60   ; minutes grounded after a fault
+//   battery = on            ; on or off, model state of charge and queue by need (engine = fleet)
+//   trip_time = 20:40       ; flight minutes of a trip, a value or shortest:longest - defaults to
+//                           ; flying until the battery is flat
+//   charge_to = 0.8         ; fraction of a full battery to charge to, or enough for the next trip
+//   telemetry = run.csv     ; time series file, binary unless the name ends in .csv
+//   telemetry_interval = 1  ; world time minutes between samples
+//   checkpoint = run.ckp    ; checkpoint file to write (engine = fleet)
+//   checkpoint_at = 90      ; world time minutes to write it at, optional - defaults to the end of the run
+//   restore = run.ckp       ; continue from a checkpoint, the scenario must match the saved run
+//   profile_trace = run.json  ; Chrome trace of the run's phases, needs a JOBY_PROFILE build
+//   demand = day.txt        ; trip requests by time of day, vehicles park between trips (engine = fleet)
+//   live = joby             ; shared memory segment to publish live snapshots to, read with joby_monitor
+//   live_interval = 1       ; world time minutes between snapshots
+//   sweep_chargers = 1:8    ; sweep over charging slots, counts and first:last[:step] ranges, e.g. 1:4,8,16,
+//                           ; up to 10000 values
+//   sweep_fleet_size = 100,1000
+//   sweep_weights = 1 1 1 1 1, 4 1 1 1 1  ; sweep over sets of model weights, one weight per model
+//   sweep_max_wait = 30     ; stop a sweep run once its average wait is sure to end up over 30 minutes
+//   sweep_output = sweep.csv
+//
+//   [model Alpha]
+//   cruise_speed = 120      ; mph
+//   battery_capacity = 320  ; kWh
+//   time_to_charge = 36     ; minutes
+//   energy_use = 1.6        ; kWh/mile at cruise
+//   passengers = 4
+//   faults_per_hour = 0.25
+//   endurance = 100         ; minutes/trip, optional - worked out from the battery when missing
+//   weight = 1              ; relative share of the fleet, optional - defaults to 1
+//
+// A file can have up to 65536 models. The fleet and static engines, replications and sweeps take at
+// most FleetState::cMaxModels (256), more need engine = tick or event.
+bool loadScenario(const std::string& path, Scenario& scenario, std::string& error);
+
+// Set one [simulation] setting by its scenario file key, used for command line overrides.
+// Returns false with a message in error for unknown keys or bad values.
+bool applySetting(Scenario& scenario, const std::string& key, const std::string& value, std::string& error);
+
+#endif //_SCENARIO_H
@@ -0,0 +1,530 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <limits>
+
+#include "./Simulation.h"
+#include "./EventSimulation.h"
+#include "./FleetSimulation.h"
+#include "./Profiler.h"
+#include "./StaticFleet.h"
+
+using std::cout;
+using std::endl;
+
+// Get system time as a double
+double sysTime() {
+    struct timespec time_spec;
+    int status = clock_gettime(CLOCK_MONOTONIC_RAW, &time_spec);
+    assert(status == 0);
+    (void)status;
+    double sys_time = time_spec.tv_sec + (time_spec.tv_nsec * 1e-9);
+    return sys_time;
+}
+
+// Function to initialize the various Vehicle "Models" in the simulation from the scenario
+void initializeModels(const Scenario& scenario, VehicleModelMap& vehicleModels) {
+    for (size_t model = 0; model < scenario.models.size(); ++model) {
+        vehicleModels[static_cast<ModelIndex>(model)] = shared_ptr<ModelData>(new ModelData {
+            scenario.models[model],
+            0, // Number in Fleet
+            0, // Accumulated Fleet Flight Time
+            0, // Accumulated Fleet Charging Time
+            0, // Accumulated Fleet Wait Time
+        });
+    }
+}
+
+namespace {
+
+// Keeps the fleet's model draws and the tick engine's landing shuffles apart from the other draws made
+// from the same seed
+const uint64_t cModelDraws = 0x61C8864680B583EBULL;
+const uint64_t cShuffleDraws = 0xD6E8FEB86659FD93ULL;
+
+// Vehicles a task of drawModels() draws the models of
+const size_t cModelDrawChunk = 65536;
+
+// Picks a model index in proportion to the model weights from a uniform draw
+class ModelPicker {
+private:
+    vector<double> cumulative;    // Running total of the weights
+    ModelIndex last;              // Last model with any weight, where rounding at the top end lands
+
+public:
+    explicit ModelPicker(const vector<double>& modelWeights) : last(0) {
+        double total = 0.0;
+        for (size_t model = 0; model < modelWeights.size(); ++model) {
+            total += modelWeights[model];
+            cumulative.push_back(total);
+            if (modelWeights[model] > 0.0) {
+                last = static_cast<ModelIndex>(model);
+            }
+        }
+    }
+
+    ModelIndex pick(double draw) const {
+        size_t model = std::upper_bound(cumulative.begin(), cumulative.end(), draw * cumulative.back()) -
+                       cumulative.begin();
+        return static_cast<ModelIndex>(std::min(model, static_cast<size_t>(last)));
+    }
+};
+
+// Model of a vehicle, from the vehicle's own draw so fleets can be built in any order
+ModelIndex drawModel(const ModelPicker& picker, unsigned long seed, VehicleIndex vehicle) {
+    return picker.pick(uniformDraw(seed ^ cModelDraws, vehicle, 0));
+}
+
+// Models of count vehicles from vehicle first on, in chunks across the pool if there is one
+vector<ModelIndex> drawModels(const ModelPicker& picker, unsigned long seed, size_t first, size_t count,
+                              ThreadPool* pool) {
+    vector<ModelIndex> models(count);
+    auto drawChunk = [&](size_t chunk) {
+        size_t end = std::min((chunk + 1) * cModelDrawChunk, count);
+        for (size_t v = chunk * cModelDrawChunk; v < end; ++v) {
+            models[v] = drawModel(picker, seed, static_cast<VehicleIndex>(first + v));
+        }
+    };
+    size_t chunks = (count + cModelDrawChunk - 1) / cModelDrawChunk;
+    if (pool) {
+        pool->run(chunks, drawChunk);
+    } else {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            drawChunk(chunk);
+        }
+    }
+    return models;
+}
+
+}
+
+// Draw a random assortment of vehicle models
+vector<ModelIndex> drawFleetModels(const vector<double>& modelWeights, unsigned int fleetSize,
+                                   unsigned long seed, ThreadPool* pool) {
+    return drawModels(ModelPicker(modelWeights), seed, 0, fleetSize, pool);
+}
+
+// Create a random assortment of vehicles and store in a vector
+vector<shared_ptr<Vehicle>> generateFleet(VehicleModelMap& vehicleModels, const vector<double>& modelWeights,
+                                          unsigned int fleetSize, unsigned long seed) {
+    vector<shared_ptr<Vehicle>> vehicles;
+    vehicles.reserve(fleetSize);
+    for (ModelIndex nextModel : drawFleetModels(modelWeights, fleetSize, seed)) {
+        shared_ptr<ModelData> model = vehicleModels[nextModel];
+        vehicles.push_back(shared_ptr<Vehicle>(new Vehicle(model)));
+        ++(model->fleetCount);
+    }
+    return vehicles;
+}
+
+void generateFleet(const vector<double>& modelWeights, unsigned int fleetSize, unsigned long seed,
+                   FleetState& fleet, ThreadPool* pool) {
+    ModelPicker picker(modelWeights);
+    fleet.reserve(fleet.size() + fleetSize);
+    if (pool) {
+        // The draws spread across the pool, vehicles are added on this thread
+        for (ModelIndex model : drawModels(picker, seed, fleet.size(), fleetSize, pool)) {
+            fleet.addVehicle(model);
+        }
+        return;
+    }
+    // Same draws without the intermediate list
+    for (unsigned int i = 0; i < fleetSize; ++i) {
+        fleet.addVehicle(drawModel(picker, seed, static_cast<VehicleIndex>(fleet.size())));
+    }
+}
+
+shared_ptr<const VertiportMap> makeVertiportMap(const Scenario& scenario) {
+    if (scenario.numberOfVertiports == 0) {
+        return nullptr;
+    }
+    return std::make_shared<VertiportMap>(scenario.numberOfVertiports, scenario.vertiportArea, scenario.seed);
+}
+
+void enableFleetModels(const Scenario& scenario, unsigned long seed, FleetState& fleet,
+                       shared_ptr<const VertiportMap> map) {
+    if (scenario.faults) {
+        fleet.enableFaults(seed, scenario.maintenanceTime);
+    }
+    if (scenario.battery) {
+        fleet.enableBattery(seed, scenario.minimumTripTime, scenario.maximumTripTime, scenario.chargeTo);
+    }
+    if (map) {
+        fleet.enableVertiports(map);
+    }
+}
+
+vector<shared_ptr<ModelData>> modelList(const VehicleModelMap& vehicleModels) {
+    vector<shared_ptr<ModelData>> models;
+    for (auto model : vehicleModels) {
+        models.push_back(model.second);
+    }
+    return models;
+}
+
+// One pass of the fixed increment simulation loop
+double stepTick(vector<shared_ptr<Vehicle>>& vehicles, ChargingStation& chargingStation, double increment,
+                RandomStream& rng, vector<shared_ptr<Vehicle>>& landed) {
+    // Iterate through vehicles.
+    // This could potentially change the vehicle's state from
+    // "en_route" -> "waiting_for_charge_queue", or "charging" -> "en_route".
+    PROFILE_PHASE(simulation_pass);
+    landed.clear();
+    bool queued = chargingStation.getNumberWaiting() > 0;
+    double quietTime = std::numeric_limits<double>::infinity();
+    {
+        PROFILE_PHASE(vehicle_iteration);
+        for (const shared_ptr<Vehicle>& v : vehicles) {
+            quietTime = std::min(quietTime, v->iterate(increment));
+            // Vehicles don't know about the charging station and the charging station doesn't know
+            // about vehicles it's not yet managing (just exited "en_route" state).
+            if (v->isWaitingForQueue()) {
+                landed.push_back(v);
+            }
+        }
+    }
+
+    // Vehicles that landed on the same pass join the queue in a random order, so none of them is always
+    // first in line. Only the order among the same pass's arrivals matters to the queue, so shuffling
+    // them gives the same queueing as shuffling the whole fleet.
+    if (landed.size() > 1) {
+        PROFILE_PHASE(landing_shuffle);
+        std::shuffle(landed.begin(), landed.end(), rng);
+    }
+    if (!landed.empty()) {
+        PROFILE_PHASE(station_handoff);
+        for (shared_ptr<Vehicle>& v : landed) {
+            // Tell the charging station about the vehicle - which changes vehicle state from
+            // "waiting_for_charge_queue" to "in_charge_queue"
+            chargingStation.addVehicle(std::move(v));
+        }
+    }
+
+    // Iterate the chargingStation which will fill charging slots with queued vehicles if there are
+    // any empty slots and queued vehicles.
+    //
+    // This could potentially change some vehicle states from
+    // "in_charge_queue" to "charging"
+    {
+        PROFILE_PHASE(station_iteration);
+        chargingStation.iterate();
+    }
+
+    // Charges started by the station weren't seen by the loop above, they need a landing or a queue
+    return landed.empty() && !queued ? quietTime : 0.0;
+}
+
+void fastForward(vector<shared_ptr<Vehicle>>& vehicles, double deltaT) {
+    PROFILE_PHASE(fast_forward);
+    for (const shared_ptr<Vehicle>& v : vehicles) {
+        v->advance(deltaT);
+    }
+}
+
+// The fixed increment simulation loop
+// In this incarnation the simulation is a single threaded loop through a vector
+// of randomly select vehicle models.
+unsigned long runTickLoop(vector<shared_ptr<Vehicle>>& vehicles, ChargingStation& chargingStation,
+                          Pacer* pacer, double increment, double runTime, RandomStream& rng,
+                          Telemetry* telemetry, bool skipQuietPasses, LiveExport* live) {
+    double currentTime = 0.0; // Start currentTime delta
+    if (pacer) {
+        pacer->start();
+    }
+
+    // Vehicles that finished their flight on the current pass
+    vector<shared_ptr<Vehicle>> landed;
+    landed.reserve(vehicles.size());
+
+    // Passes made, the profile of each pass is kept with -DJOBY_PROFILE=ON (see Profiler.h)
+    unsigned long totalIterations = 0;
+    // Main simulation loop, we're done when it is over.
+    while (currentTime < runTime) {
+        if (pacer) {
+            // Sleep until the next tick is due, the increment covers every tick due so far
+            increment = pacer->next();
+        }
+
+        if (telemetry && telemetry->isDue(currentTime)) {
+            PROFILE_PHASE(telemetry_sample);
+            telemetry->record(currentTime, vehicles, chargingStation);
+        }
+        if (live && live->isDue(currentTime)) {
+            PROFILE_PHASE(live_publish);
+            live->publish(currentTime, vehicles, chargingStation);
+        }
+
+        double quietTime = stepTick(vehicles, chargingStation, increment, rng, landed);
+
+        ++totalIterations;
+
+        // Increment the currentTime for the next iteration. Fixed steps work it out from the number of
+        // passes, so rounding doesn't build up and add a pass at the end of the run.
+        currentTime = pacer ? currentTime + increment : static_cast<double>(totalIterations) * increment;
+
+        // Jump over the passes in which no vehicle can change state. Stop one pass short of the next
+        // change so rounding can't carry a vehicle past it, and step the last pass of the run and
+        // any pass a telemetry sample or live snapshot is due on.
+        if (skipQuietPasses && !pacer && quietTime > 0.0) {
+            double passes = std::floor(quietTime / increment) - 1.0;
+            passes = std::min(passes, std::ceil((runTime - currentTime) / increment) - 1.0);
+            if (telemetry) {
+                passes = std::min(passes, std::ceil((telemetry->getNextSampleTime() - currentTime) / increment));
+            }
+            if (live) {
+                passes = std::min(passes, std::ceil((live->getNextPublishTime() - currentTime) / increment));
+            }
+            if (passes >= 1.0) {
+                unsigned long quietPasses = static_cast<unsigned long>(passes);
+                double deltaT = static_cast<double>(quietPasses) * increment;
+                fastForward(vehicles, deltaT);
+                totalIterations += quietPasses;
+                currentTime = static_cast<double>(totalIterations) * increment;
+            }
+        }
+    }
+    if (telemetry) {
+        telemetry->record(currentTime, vehicles, chargingStation);
+    }
+    if (live) {
+        live->publish(currentTime, vehicles, chargingStation);
+    }
+    return totalIterations;
+}
+
+void printResults(const vector<shared_ptr<Vehicle>>& vehicles, const VehicleModelMap& modelStates,
+                  bool printVehicles) {
+    // Print vehicle stats
+    if (printVehicles) {
+        cout << "Per Vehicle Stats:\n";
+        for (shared_ptr<Vehicle> v: vehicles) {
+            v->printResult();
+        }
+        cout << "\n";
+    }
+
+    // Print model stats
+    cout << "Per Model Stats:\n";
+    for(auto model: modelStates) {
+        model.second->prinResult();
+    }
+    // Lines aren't flushed one by one, a big fleet prints a lot of them
+    cout << std::flush;
+}
+
+void printResults(const FleetState& fleet, const VehicleModelMap& modelStates) {
+    // Print vehicle stats
+    if (fleet.hasVehicleTotals()) {
+        cout << "Per Vehicle Stats:\n";
+        for (VehicleIndex v = 0; v < fleet.size(); ++v) {
+            fleet.printResult(v);
+        }
+        cout << "\n";
+    }
+
+    // Print model stats
+    cout << "Per Model Stats:\n";
+    for(auto model: modelStates) {
+        model.second->prinResult();
+    }
+    // Lines aren't flushed one by one, a big fleet prints a lot of them
+    cout << std::flush;
+}
+
+namespace {
+
+// Print what the fleet engine's state takes up before the run starts
+void printMemoryUsage(const FleetState& fleet, const StationNetwork& stations) {
+    const double cMegabyte = 1024.0 * 1024.0;
+    size_t fleetBytes = fleet.memoryUsage();
+    size_t stationBytes = stations.memoryUsage();
+    double perVehicle = fleet.size() > 0 ? static_cast<double>(fleetBytes + stationBytes) / fleet.size() : 0.0;
+    cout << "Memory, fleet/stations(MB)/bytes-per-vehicle: " << fleetBytes / cMegabyte << "/"
+         << stationBytes / cMegabyte << "/" << perVehicle << endl;
+}
+
+// Print the profile of a run and write its trace if the scenario asks for one
+void reportProfile(Profiler* profiler, const Scenario& scenario) {
+    if (!profiler) {
+        return;
+    }
+    Profiler::deactivate();
+    profiler->printSummary(cout);
+    std::string error;
+    if (!scenario.profileTracePath.empty() && !profiler->writeTrace(scenario.profileTracePath, error)) {
+        std::cerr << error << endl;
+    }
+}
+
+// The static engine's part of runSimulation(), main() has checked the scenario has the built in models
+void runStaticSimulation(const Scenario& scenario, const VehicleModelMap& modelStates,
+                         Pacer* pacer, Profiler* profiler) {
+    DefaultStaticFleet fleet(static_cast<unsigned int>(scenario.numberOfChargingSlots));
+    vector<ModelIndex> fleetModels = drawFleetModels(scenario.modelWeights, scenario.fleetSize, scenario.seed);
+    vector<size_t> groupSizes(DefaultStaticFleet::cNumberOfModels, 0);
+    for (ModelIndex model : fleetModels) {
+        ++groupSizes[model];
+    }
+    fleet.reserve(groupSizes);
+    for (ModelIndex model : fleetModels) {
+        fleet.addVehicle(model);
+    }
+    cout << "Memory, fleet(MB)/bytes-per-vehicle: " << fleet.memoryUsage() / (1024.0 * 1024.0) << "/"
+         << (fleet.size() > 0 ? static_cast<double>(fleet.memoryUsage()) / fleet.size() : 0.0) << endl;
+
+    double startTime = sysTime();
+    unsigned long totalIterations = runStaticLoop(fleet, pacer, scenario.increment, scenario.runTime);
+    double totalRunTime = sysTime() - startTime;
+    cout << "Simulation finished, total-run-time(seconds)/total-iterations: " << totalRunTime << "/" << totalIterations << endl;
+    if (pacer) {
+        pacer->printReport();
+    }
+    reportProfile(profiler, scenario);
+    cout << endl;
+
+    // Only model totals are kept
+    fleet.writeModelTotals(modelList(modelStates));
+    printResults(vector<shared_ptr<Vehicle>>(), modelStates, false);
+}
+
+}
+
+// Runs the actual simulation
+//
+// The scenario engine selects how: tick_engine iterates every vehicle on every pass, event_engine jumps
+// from one state change to the next (the wall clock is ignored), fleet_engine iterates a structure-of-arrays
+// fleet on every pass across numberOfThreads threads, static_engine does the same on one thread for the
+// built in models.
+void runSimulation(const Scenario& scenario) {
+    // Every draw of the run comes from the seed, so the run can be repeated with --seed
+    cout << "Seed: " << scenario.seed << endl;
+
+    // Create a map from model index to ModelData records
+    VehicleModelMap modelStates;
+    initializeModels(scenario, modelStates);
+
+    // The event engine has no regular passes to sample on
+    std::unique_ptr<Telemetry> telemetry;
+    if (!scenario.telemetryPath.empty() && (scenario.engine == SimulationEngine::tick_engine ||
+                                            scenario.engine == SimulationEngine::fleet_engine)) {
+        telemetry.reset(new Telemetry(scenario.telemetryPath, scenario.telemetryInterval, modelList(modelStates)));
+        if (!telemetry->isOpen()) {
+            std::cerr << scenario.telemetryPath << ": can't open telemetry file" << endl;
+            return;
+        }
+    }
+
+    std::unique_ptr<LiveExport> live;
+    if (!scenario.liveName.empty() && (scenario.engine == SimulationEngine::tick_engine ||
+                                       scenario.engine == SimulationEngine::fleet_engine)) {
+        live.reset(new LiveExport(scenario.liveName, scenario.liveInterval, modelList(modelStates)));
+        if (!live->isOpen()) {
+            std::cerr << live->getName() << ": can't create live export shared memory" << endl;
+            return;
+        }
+    }
+
+    // Live runs step in time with the wall clock. The event engine has no steps to pace and runs flat out.
+    std::unique_ptr<Pacer> pacer;
+    if (scenario.useRealTime && scenario.engine != SimulationEngine::event_engine) {
+        pacer.reset(new Pacer(scenario.tickRate, scenario.timeScale, scenario.maxCatchUp));
+    } else if (scenario.useRealTime) {
+        cout << "The event engine jumps from one state change to the next, stepping with the clock is ignored" << endl;
+    }
+
+    // Profiling builds profile every run (see Profiler.h)
+    std::unique_ptr<Profiler> profiler;
+    if (cProfilingBuild) {
+        profiler.reset(new Profiler(modelList(modelStates), !scenario.profileTracePath.empty()));
+        profiler->activate();
+    }
+
+    if (scenario.engine == SimulationEngine::fleet_engine) {
+        FleetState fleet(modelList(modelStates));
+        fleet.keepVehicleTotals(scenario.vehicleResults);
+        shared_ptr<const VertiportMap> vertiports = makeVertiportMap(scenario);
+        enableFleetModels(scenario, scenario.seed, fleet, vertiports);
+        std::unique_ptr<FleetDemand> demand;
+        if (!scenario.demandPath.empty()) {
+            DemandProfile profile;
+            std::string error;
+            if (!profile.load(scenario.demandPath, error)) {
+                std::cerr << error << endl;
+                return;
+            }
+            fleet.enableDemand();
+            demand.reset(new FleetDemand(profile, scenario.seed));
+        }
+        SessionStatistics sessions(scenario.models.size());
+        fleet.recordSessions(&sessions);
+        StationNetwork stations(scenario.numberOfStations, scenario.numberOfChargingSlots, scenario.fleetSize,
+                                makeRoutingPolicy(scenario.routing, scenario.numberOfStations, vertiports.get()),
+                                scenario.battery);
+        FleetCheckpoint checkpoint{FleetClock{0.0, 0}, scenario.checkpointPath,
+                                   std::min(scenario.checkpointTime, scenario.runTime)};
+        ThreadPool pool(scenario.numberOfThreads);
+        if (scenario.restorePath.empty()) {
+            generateFleet(scenario.modelWeights, scenario.fleetSize, scenario.seed, fleet, &pool);
+        } else {
+            // The fleet and its place in the run come from the checkpoint
+            std::string error;
+            if (!loadCheckpoint(scenario.restorePath, checkpoint.start, fleet, stations, error)) {
+                std::cerr << error << endl;
+                return;
+            }
+        }
+        printMemoryUsage(fleet, stations);
+
+        double startTime = sysTime();
+        unsigned long totalIterations = runFleetLoop(fleet, stations, pacer.get(),
+                                                     scenario.increment, scenario.runTime, pool, telemetry.get(),
+                                                     &checkpoint, demand.get(), live.get());
+        double totalRunTime = sysTime() - startTime;
+        cout << "Simulation finished, total-run-time(seconds)/total-iterations: " << totalRunTime << "/" << totalIterations << endl;
+        if (pacer) {
+            pacer->printReport();
+        }
+        if (demand) {
+            demand->printReport();
+        }
+        reportProfile(profiler.get(), scenario);
+        cout << endl;
+
+        printResults(fleet, modelStates);
+        sessions.print(cout, scenario.models);
+        return;
+    }
+
+    if (scenario.engine == SimulationEngine::static_engine) {
+        runStaticSimulation(scenario, modelStates, pacer.get(), profiler.get());
+        return;
+    }
+
+    // Generate the Fleet
+    vector<shared_ptr<Vehicle>> vehicles = generateFleet(modelStates, scenario.modelWeights, scenario.fleetSize, scenario.seed);
+    ChargingStation chargingStation(scenario.numberOfChargingSlots);
+
+    double startTime = sysTime();
+    unsigned long totalIterations;
+    if (scenario.engine == SimulationEngine::event_engine) {
+        totalIterations = runEventLoop(vehicles, chargingStation, scenario.runTime);
+    } else {
+        RandomStream rng(scenario.seed ^ cShuffleDraws);
+        totalIterations = runTickLoop(vehicles, chargingStation, pacer.get(), scenario.increment,
+                                      scenario.runTime, rng, telemetry.get(), scenario.fastForward, live.get());
+    }
+
+    // Print some run data
+    double totalRunTime = sysTime() - startTime;
+    cout << "Simulation finished, total-run-time(seconds)/total-iterations: " << totalRunTime << "/" << totalIterations << endl;
+    if (pacer) {
+        pacer->printReport();
+    }
+    reportProfile(profiler.get(), scenario);
+    cout << endl;
+
+    // Done with the simulation, now print out results.
+    printResults(vehicles, modelStates, scenario.vehicleResults);
+}
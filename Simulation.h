@@ -0,0 +1,92 @@
+#ifndef _SIMULATION_H
+#define _SIMULATION_H
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "./Vehicle.h"
+#include "./ChargingStation.h"
+#include "./FleetState.h"
+#include "./LiveExport.h"
+#include "./Pacer.h"
+#include "./RandomStream.h"
+#include "./Scenario.h"
+#include "./Telemetry.h"
+
+using std::shared_ptr;
+using std::vector;
+
+// Model records keyed by their index in the scenario
+typedef std::map<ModelIndex, shared_ptr<ModelData>> VehicleModelMap;
+
+// Get system time as a double
+double sysTime();
+
+// Function to initialize the various Vehicle "Models" of a scenario in the simulation.
+void initializeModels(const Scenario& scenario, VehicleModelMap& vehicleModels);
+
+// Draw the models of a random assortment of fleetSize vehicles, each model index is drawn in proportion
+// to its weight. Each vehicle's model comes from its own draw of seed (see RandomStream.h), so the fleet
+// is the same drawn across a pool or not.
+vector<ModelIndex> drawFleetModels(const vector<double>& modelWeights, unsigned int fleetSize,
+                                   unsigned long seed, ThreadPool* pool = nullptr);
+
+// Create a random assortment of fleetSize vehicles from the models in vehicleModels.
+// Updates the fleetCount of each model.
+vector<shared_ptr<Vehicle>> generateFleet(VehicleModelMap& vehicleModels, const vector<double>& modelWeights,
+                                          unsigned int fleetSize, unsigned long seed);
+
+// Same as above for a FleetState, which must have been created with modelList(vehicleModels). Vehicles
+// are drawn by their index in the fleet, so adding them in pieces gives the same fleet as all at once,
+// and with a pool the models are drawn across it.
+void generateFleet(const vector<double>& modelWeights, unsigned int fleetSize, unsigned long seed,
+                   FleetState& fleet, ThreadPool* pool = nullptr);
+
+// The vertiports of a scenario, laid out from its seed, or null if it has none
+shared_ptr<const VertiportMap> makeVertiportMap(const Scenario& scenario);
+
+// Turn on the fault and battery models of a scenario for an empty fleet, with their draws seeded by seed,
+// and trips between the vertiports of map if it isn't null
+void enableFleetModels(const Scenario& scenario, unsigned long seed, FleetState& fleet,
+                       shared_ptr<const VertiportMap> map = nullptr);
+
+// The model records in ModelIndex order.
+vector<shared_ptr<ModelData>> modelList(const VehicleModelMap& vehicleModels);
+
+// One pass of runTickLoop(): iterate every vehicle by increment, hand the vehicles that landed to the
+// charging station in a random order, then iterate the charging station. landed is scratch space, reserve
+// it to the fleet size so the pass doesn't allocate.
+// Returns the world time until the next vehicle state change (the least Vehicle::timeRemaining()), or 0
+// if something changed on this pass and the next change isn't known yet.
+double stepTick(vector<shared_ptr<Vehicle>>& vehicles, ChargingStation& chargingStation, double increment,
+                RandomStream& rng, vector<shared_ptr<Vehicle>>& landed);
+
+// Advance every vehicle by deltaT at once (see Vehicle::advance()), deltaT must end before any of them
+// changes state. The totals gain the same time as passes adding up to deltaT, to within rounding.
+void fastForward(vector<shared_ptr<Vehicle>>& vehicles, double deltaT);
+
+// The fixed increment simulation loop, returns the number of passes made over the fleet.
+//   pacer       - If not null, step in time with the wall clock: each pass waits for the pacer's next
+//                 tick and steps the world time it returns. Null steps by increment flat out.
+//   increment   - World time per pass when there is no pacer.
+//   runTime     - Number of world time minutes to run the simulation
+//   telemetry   - If not null, sampled whenever it is due and once at the end of the run
+//   skipQuietPasses - If true and there is no pacer, jump over the passes in which no vehicle can change
+//                 state with fastForward(). Nothing queues or charges differently, so the results are
+//                 the same as stepping every pass, to within the rounding of adding up the increments.
+//   live        - If not null, published whenever it is due and once at the end of the run
+unsigned long runTickLoop(vector<shared_ptr<Vehicle>>& vehicles, ChargingStation& chargingStation,
+                          Pacer* pacer, double increment, double runTime, RandomStream& rng,
+                          Telemetry* telemetry = nullptr, bool skipQuietPasses = false, LiveExport* live = nullptr);
+
+// Print per vehicle and per model results. The per vehicle results of a fleet are only printed when
+// it keeps per vehicle totals.
+void printResults(const vector<shared_ptr<Vehicle>>& vehicles, const VehicleModelMap& modelStates,
+                  bool printVehicles = true);
+void printResults(const FleetState& fleet, const VehicleModelMap& modelStates);
+
+// Runs the actual simulation of a scenario with the selected engine
+void runSimulation(const Scenario& scenario);
+
+#endif //_SIMULATION_H
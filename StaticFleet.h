@@ -0,0 +1,457 @@
+#ifndef _STATIC_FLEET_H
+#define _STATIC_FLEET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "./FleetState.h"
+#include "./Pacer.h"
+#include "./Profiler.h"
+#include "./Vehicle.h"
+
+// The fleet engine for a model set fixed at build time.
+//
+// Each model is a type with a constexpr parameters() function, and StaticFleet<Models...> keeps a
+// StaticModelGroup of vehicles for each of them. A group's step is instantiated for its model, so the
+// endurance and charge time are constants in the loop rather than loads from a parameter table, and every
+// vehicle in the loop is the same model. A vehicle takes 13 bytes (state, operation time and its index in
+// the fleet) against the fleet engine's 22. Passes run on one thread, about as fast as the fleet engine's
+// on one thread (see BM_StaticEngineStep).
+//
+// The rules are the fleet engine's with one charging station and no faults or battery model. Vehicles
+// that land on the same pass are handed to the station in fleet index order, same as runFleetLoop(), so
+// the two engines queue the same vehicles on the same passes and agree on the model totals to within the
+// rounding of summing them in a different order.
+
+// Parameters of a model known at build time, the constexpr counterpart of ModelParameters
+struct StaticModelParameters {
+    const char* label;
+    double cruiseSpeed;           // mph
+    double batteryCapacity;       // kWh
+    double timeToCharge;          // minutes
+    double energyUseAtCruise;     // kWh/mile
+    unsigned int passengerCount;
+    double maxFaultsPerHour;
+    double endurance;             // minutes/trip
+
+    ModelParameters toModelParameters() const {
+        return ModelParameters{label, cruiseSpeed, batteryCapacity, timeToCharge, energyUseAtCruise, passengerCount,
+                               maxFaultsPerHour, endurance};
+    }
+
+    bool operator==(const ModelParameters& model) const {
+        return model.label == label && model.cruiseSpeed == cruiseSpeed && model.batteryCapacity == batteryCapacity &&
+               model.timeToCharge == timeToCharge && model.energyUseAtCruise == energyUseAtCruise &&
+               model.passengerCount == passengerCount && model.MaxFaultsPerHour == maxFaultsPerHour &&
+               model.endurance == endurance;
+    }
+};
+
+// The built in models of defaultScenario()
+struct AlphaModel {
+    static constexpr StaticModelParameters parameters() {
+        return {"Alpha", 120.0, 320.0, 0.6 * 60.0, 1.6, 4, 0.25, (320.0 * 60.0) / (120.0 * 1.6)};
+    }
+};
+struct BetaModel {
+    static constexpr StaticModelParameters parameters() {
+        return {"Beta", 100.0, 100.0, 0.2 * 60.0, 1.5, 5, 0.1, (100.0 * 60.0) / (100.0 * 1.5)};
+    }
+};
+struct CharlieModel {
+    static constexpr StaticModelParameters parameters() {
+        return {"Charlie", 160.0, 220.0, 0.8 * 60.0, 2.2, 3, 0.05, (220.0 * 60.0) / (160.0 * 2.2)};
+    }
+};
+struct DeltaModel {
+    static constexpr StaticModelParameters parameters() {
+        return {"Delta", 90.0, 120.0, 0.62 * 60.0, 0.8, 2, 0.22, (120.0 * 60.0) / (120.0 * 1.6)};
+    }
+};
+struct EchoModel {
+    static constexpr StaticModelParameters parameters() {
+        return {"Echo", 30.0, 150.0, 0.3 * 60.0, 5.8, 2, 0.61, (150.0 * 60.0) / (30.0 * 5.8)};
+    }
+};
+
+// A vehicle of a StaticFleet: its index in the fleet, its model and its place in the model's group
+struct StaticVehicle {
+    VehicleIndex vehicle;
+    ModelIndex model;
+    uint32_t position;
+};
+
+// The vehicles of one model, in structure-of-arrays form like FleetState
+template <typename Model>
+class StaticModelGroup {
+private:
+    vector<uint8_t> operationState;      // OperationState, plus FleetState::cTransitionFlag while a change is pending
+    vector<double> currentOperationTime;
+    vector<VehicleIndex> vehicleIndex;   // Index in the whole fleet, orders the landings of a pass
+
+    // Completed operations less the start of the operations in progress, same as FleetState
+    ModelTotals totals;
+
+    void addTime(uint8_t state, double time) {
+        switch (state) {
+            case OperationState::en_route:
+                totals.totalFlightTime += time;
+                break;
+            case OperationState::charging:
+                totals.totalChargingTime += time;
+                break;
+            case OperationState::in_charge_queue:
+                totals.totalWaitingTime += time;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // FleetState's kernel with the operation lengths folded in, the untimed (queue) states never end.
+    // Unlike FleetState's this doesn't vectorize, but every vehicle in the loop is the same model, so
+    // neighbours are mostly in the same state and the branches are predicted well. Returns the number of
+    // flagged vehicles.
+    static unsigned int iterateKernel(size_t n, double deltaT, uint8_t* __restrict state, double* __restrict opTime) {
+        constexpr StaticModelParameters cModel = Model::parameters();
+        constexpr double cNever = std::numeric_limits<double>::infinity();
+        unsigned int transitions = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t s = state[i];
+            const double length = s == OperationState::en_route ? cModel.endurance :
+                                  s == OperationState::charging ? cModel.timeToCharge : cNever;
+
+            // Completed operations keep their last time so the scalar pass can work out the overrun
+            const double newOperationTime = opTime[i] + deltaT;
+            const bool done = newOperationTime + cOperationTimeTolerance >= length;
+            opTime[i] = done ? opTime[i] : newOperationTime;
+
+            state[i] = static_cast<uint8_t>(s | (done ? FleetState::cTransitionFlag : 0));
+            transitions += done;
+        }
+        return transitions;
+    }
+
+public:
+    StaticModelGroup() : totals{} {}
+
+    // Prevent unneeded defaults
+    StaticModelGroup(const StaticModelGroup&) = delete;
+    StaticModelGroup& operator=(const StaticModelGroup&) = delete;
+
+    void reserve(size_t groupSize) {
+        operationState.reserve(groupSize);
+        currentOperationTime.reserve(groupSize);
+        vehicleIndex.reserve(groupSize);
+    }
+
+    // Add an en_route vehicle, returns its position in the group
+    uint32_t addVehicle(VehicleIndex vehicle) {
+        operationState.push_back(OperationState::en_route);
+        currentOperationTime.push_back(0.0);
+        vehicleIndex.push_back(vehicle);
+        return static_cast<uint32_t>(operationState.size() - 1);
+    }
+
+    size_t size() const { return operationState.size(); }
+
+    // Iterate every vehicle of the group, same rules as FleetState::iterate(). Vehicles that land are
+    // appended to landed, those that finish charging are back en_route. Returns the number that finished
+    // charging, their chargers are free.
+    unsigned int iterate(double deltaT, ModelIndex model, vector<StaticVehicle>& landed) {
+        constexpr StaticModelParameters cModel = Model::parameters();
+        const size_t groupSize = size();
+        unsigned int charged = 0;
+        for (size_t begin = 0; begin < groupSize; begin += FleetState::cBlockSize) {
+            const size_t end = std::min(begin + FleetState::cBlockSize, groupSize);
+            if (iterateKernel(end - begin, deltaT, &operationState[begin], &currentOperationTime[begin]) == 0) {
+                continue;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                if ((operationState[i] & FleetState::cTransitionFlag) == 0) {
+                    continue;
+                }
+                operationState[i] &= ~FleetState::cTransitionFlag;
+                const bool flying = operationState[i] == OperationState::en_route;
+                const double length = flying ? cModel.endurance : cModel.timeToCharge;
+                const double overrun = std::max(currentOperationTime[i] + deltaT - length, 0.0);
+                addTime(operationState[i], currentOperationTime[i]);
+                if (flying) {
+                    operationState[i] = OperationState::waiting_for_charge_queue;
+                    landed.push_back(StaticVehicle{vehicleIndex[i], model, static_cast<uint32_t>(i)});
+                } else {
+                    operationState[i] = OperationState::en_route;
+                    ++charged;
+                }
+                currentOperationTime[i] = overrun;
+                addTime(operationState[i], -overrun);
+            }
+        }
+        return charged;
+    }
+
+    // Same as the FleetState calls of the same name
+    void setInWaitQueue(uint32_t position) {
+        operationState[position] = OperationState::in_charge_queue;
+        addTime(OperationState::in_charge_queue, -currentOperationTime[position]);
+    }
+    void setCharging(uint32_t position) {
+        addTime(operationState[position], currentOperationTime[position]);
+        operationState[position] = OperationState::charging;
+        currentOperationTime[position] = 0.0;
+    }
+    bool isCharging(uint32_t position) const { return operationState[position] == OperationState::charging; }
+    OperationState getOpState(uint32_t position) const { return static_cast<OperationState>(operationState[position]); }
+
+    // Totals so far, including the operations in progress
+    ModelTotals getTotals() const {
+        ModelTotals current = totals;
+        for (size_t i = 0; i < size(); ++i) {
+            switch (operationState[i]) {
+                case OperationState::en_route:
+                    current.totalFlightTime += currentOperationTime[i];
+                    break;
+                case OperationState::charging:
+                    current.totalChargingTime += currentOperationTime[i];
+                    break;
+                case OperationState::in_charge_queue:
+                    current.totalWaitingTime += currentOperationTime[i];
+                    break;
+                default:
+                    break;
+            }
+        }
+        return current;
+    }
+
+    size_t memoryUsage() const {
+        return operationState.capacity() * sizeof(uint8_t) + currentOperationTime.capacity() * sizeof(double) +
+               vehicleIndex.capacity() * sizeof(VehicleIndex);
+    }
+};
+
+// A fleet of the given models and one charging station
+template <typename... Models>
+class StaticFleet {
+private:
+    std::tuple<StaticModelGroup<Models>...> groups;
+    VehicleIndex numberOfVehicles;
+
+    // The charging station, same rules as FleetChargingStation serving in arrival order
+    const unsigned int cNumberOfChargingSlots;
+    vector<StaticVehicle> chargers;
+    std::deque<StaticVehicle> waitQueue;
+
+    // Vehicles that landed on the current pass
+    vector<StaticVehicle> landed;
+
+    // Call f(group, model) for every model group in model order
+    template <typename F, size_t... I>
+    void forEachGroup(F& f, std::index_sequence<I...>) {
+        int expand[] = {0, (f(std::get<I>(groups), static_cast<ModelIndex>(I)), 0)...};
+        (void)expand;
+    }
+    template <typename F, size_t... I>
+    void forEachGroup(F& f, std::index_sequence<I...>) const {
+        int expand[] = {0, (f(std::get<I>(groups), static_cast<ModelIndex>(I)), 0)...};
+        (void)expand;
+    }
+    template <typename F>
+    void forEachGroup(F f) { forEachGroup(f, std::index_sequence_for<Models...>()); }
+    template <typename F>
+    void forEachGroup(F f) const { forEachGroup(f, std::index_sequence_for<Models...>()); }
+
+    // Call f(group) for the group of one model
+    template <typename F>
+    void withGroup(ModelIndex model, F f) {
+        forEachGroup([&](auto& group, ModelIndex m) {
+            if (m == model) {
+                f(group);
+            }
+        });
+    }
+    template <typename F>
+    void withGroup(ModelIndex model, F f) const {
+        forEachGroup([&](const auto& group, ModelIndex m) {
+            if (m == model) {
+                f(group);
+            }
+        });
+    }
+
+public:
+    static const size_t cNumberOfModels = sizeof...(Models);
+    static_assert(sizeof...(Models) <= FleetState::cMaxModels, "at most cMaxModels models");
+
+    explicit StaticFleet(unsigned int numberOfChargingSlots) :
+            numberOfVehicles(0),
+            cNumberOfChargingSlots(numberOfChargingSlots)
+    {
+        chargers.reserve(numberOfChargingSlots);
+    }
+
+    // Prevent unneeded defaults
+    StaticFleet(const StaticFleet&) = delete;
+    StaticFleet& operator=(const StaticFleet&) = delete;
+
+    // The model parameters in model index order
+    static vector<ModelParameters> modelParameters() {
+        return vector<ModelParameters>{Models::parameters().toModelParameters()...};
+    }
+
+    // Whether a scenario's models are the ones the fleet was built for, in the same order
+    static bool hasModels(const vector<ModelParameters>& models) {
+        const StaticModelParameters parameters[] = {Models::parameters()...};
+        if (models.size() != cNumberOfModels) {
+            return false;
+        }
+        for (size_t m = 0; m < cNumberOfModels; ++m) {
+            if (!(parameters[m] == models[m])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Reserve space for the given number of vehicles of each model
+    void reserve(const vector<size_t>& groupSizes) {
+        forEachGroup([&](auto& group, ModelIndex m) {
+            group.reserve(groupSizes[m]);
+        });
+    }
+
+    // Add an en_route vehicle of the given model, returns its index in the fleet
+    VehicleIndex addVehicle(ModelIndex model) {
+        withGroup(model, [&](auto& group) {
+            group.addVehicle(numberOfVehicles);
+        });
+        return numberOfVehicles++;
+    }
+
+    size_t size() const { return numberOfVehicles; }
+
+    size_t size(ModelIndex model) const {
+        size_t groupSize = 0;
+        withGroup(model, [&](const auto& group) {
+            groupSize = group.size();
+        });
+        return groupSize;
+    }
+
+    // One pass of runFleetLoop() with one station
+    void step(double deltaT) {
+        PROFILE_PHASE(simulation_pass);
+        landed.clear();
+        unsigned int charged = 0;
+        {
+            PROFILE_PHASE(vehicle_iteration);
+            forEachGroup([&](auto& group, ModelIndex m) {
+                charged += group.iterate(deltaT, m, landed);
+            });
+        }
+        if (!landed.empty()) {
+            PROFILE_PHASE(station_handoff);
+            // Each group's landings are in index order, merge them
+            std::sort(landed.begin(), landed.end(), [](const StaticVehicle& a, const StaticVehicle& b) {
+                return a.vehicle < b.vehicle;
+            });
+            for (const StaticVehicle& v : landed) {
+                withGroup(v.model, [&](auto& group) {
+                    group.setInWaitQueue(v.position);
+                });
+                waitQueue.push_back(v);
+            }
+        }
+
+        // Same as StationNetwork, the station only has work to do when a vehicle arrives or leaves
+        if (landed.empty() && charged == 0) {
+            return;
+        }
+        PROFILE_PHASE(station_iteration);
+        for (size_t slot = 0; charged > 0 && slot < chargers.size();) {
+            bool charging = false;
+            withGroup(chargers[slot].model, [&](const auto& group) {
+                charging = group.isCharging(chargers[slot].position);
+            });
+            if (!charging) {
+                chargers[slot] = chargers.back();
+                chargers.pop_back();
+                --charged;
+            } else {
+                ++slot;
+            }
+        }
+        while (!waitQueue.empty() && chargers.size() < cNumberOfChargingSlots) {
+            StaticVehicle v = waitQueue.front();
+            waitQueue.pop_front();
+            withGroup(v.model, [&](auto& group) {
+                group.setCharging(v.position);
+            });
+            chargers.push_back(v);
+        }
+    }
+
+    size_t getNumberCharging() const { return chargers.size(); }
+    size_t getNumberWaiting() const { return waitQueue.size(); }
+
+    // Totals of the vehicles of one model so far, including the operations in progress
+    ModelTotals getTotals(ModelIndex model) const {
+        ModelTotals totals{};
+        withGroup(model, [&](const auto& group) {
+            totals = group.getTotals();
+        });
+        return totals;
+    }
+
+    // Set the fleet count and totals of ModelData records made from modelParameters(), in model order
+    void writeModelTotals(const vector<shared_ptr<ModelData>>& models) const {
+        for (ModelIndex m = 0; m < cNumberOfModels; ++m) {
+            ModelTotals totals = getTotals(m);
+            models[m]->fleetCount = static_cast<unsigned int>(size(m));
+            models[m]->totalFlightTime = totals.totalFlightTime;
+            models[m]->totalChargingTime = totals.totalChargingTime;
+            models[m]->totalWaitingTime = totals.totalWaitingTime;
+        }
+    }
+
+    // Bytes allocated for the fleet and its station
+    size_t memoryUsage() const {
+        size_t bytes = sizeof(*this) + chargers.capacity() * sizeof(StaticVehicle) +
+                       waitQueue.size() * sizeof(StaticVehicle) + landed.capacity() * sizeof(StaticVehicle);
+        forEachGroup([&](const auto& group, ModelIndex) {
+            bytes += group.memoryUsage();
+        });
+        return bytes;
+    }
+};
+
+// The built in models of defaultScenario()
+typedef StaticFleet<AlphaModel, BetaModel, CharlieModel, DeltaModel, EchoModel> DefaultStaticFleet;
+
+// The fixed increment simulation loop over a StaticFleet, same as runFleetLoop() without telemetry or
+// checkpoints. Returns the number of passes made over the fleet.
+template <typename Fleet>
+unsigned long runStaticLoop(Fleet& fleet, Pacer* pacer, double increment, double runTime) {
+    double currentTime = 0.0;
+    if (pacer) {
+        pacer->start();
+    }
+    unsigned long totalIterations = 0;
+    while (currentTime < runTime) {
+        if (pacer) {
+            increment = pacer->next();
+        }
+        fleet.step(increment);
+        ++totalIterations;
+        currentTime = pacer ? currentTime + increment : static_cast<double>(totalIterations) * increment;
+    }
+    return totalIterations;
+}
+
+#endif //_STATIC_FLEET_H
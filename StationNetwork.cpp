@@ -0,0 +1,266 @@
+#include <cassert>
+#include <string>
+#include <utility>
+
+#include "./Checkpoint.h"
+#include "./StationNetwork.h"
+
+NearestRouting::NearestRouting(StationIndex numberOfStations, const VertiportMap* map) :
+        cNumberOfStations(numberOfStations)
+{
+    if (map) {
+        assert(numberOfStations <= map->size());
+        const vector<Position>& positions = map->getPositions();
+        index.reset(new NearestIndex(vector<Position>(positions.begin(), positions.begin() + numberOfStations)));
+    }
+}
+
+StationIndex NearestRouting::route(const FleetState& fleet, VehicleIndex vehicle) {
+    if (index) {
+        return index->nearest(fleet.getPosition(vehicle));
+    }
+    return vehicle % cNumberOfStations;
+}
+
+LeastQueuedRouting::LeastQueuedRouting(StationIndex numberOfStations) :
+        heap(numberOfStations),
+        heapPosition(numberOfStations),
+        stationLoad(numberOfStations)
+{
+    reset();
+}
+
+bool LeastQueuedRouting::lighter(StationIndex a, StationIndex b) const {
+    return stationLoad[a] < stationLoad[b] || (stationLoad[a] == stationLoad[b] && a < b);
+}
+
+void LeastQueuedRouting::swapPositions(size_t a, size_t b) {
+    std::swap(heap[a], heap[b]);
+    heapPosition[heap[a]] = a;
+    heapPosition[heap[b]] = b;
+}
+
+StationIndex LeastQueuedRouting::route(const FleetState& fleet, VehicleIndex vehicle) {
+    return heap[0];
+}
+
+void LeastQueuedRouting::loadChanged(StationIndex station, size_t load) {
+    stationLoad[station] = load;
+
+    // Sift up
+    size_t position = heapPosition[station];
+    while (position > 0 && lighter(station, heap[(position - 1) / 2])) {
+        swapPositions(position, (position - 1) / 2);
+        position = (position - 1) / 2;
+    }
+
+    // Sift down
+    for (;;) {
+        size_t lightest = position;
+        for (size_t child = 2 * position + 1; child <= 2 * position + 2 && child < heap.size(); ++child) {
+            if (lighter(heap[child], heap[lightest])) {
+                lightest = child;
+            }
+        }
+        if (lightest == position) {
+            break;
+        }
+        swapPositions(position, lightest);
+        position = lightest;
+    }
+}
+
+void LeastQueuedRouting::reset() {
+    // All empty, in station order is a valid heap
+    for (StationIndex s = 0; s < heap.size(); ++s) {
+        heap[s] = s;
+        heapPosition[s] = s;
+        stationLoad[s] = 0;
+    }
+}
+
+RoundRobinRouting::RoundRobinRouting(StationIndex numberOfStations) :
+        cNumberOfStations(numberOfStations),
+        next(0)
+{}
+
+StationIndex RoundRobinRouting::route(const FleetState& fleet, VehicleIndex vehicle) {
+    StationIndex station = next;
+    if (++next == cNumberOfStations) {
+        next = 0;
+    }
+    return station;
+}
+
+void RoundRobinRouting::reset() {
+    next = 0;
+}
+
+void RoundRobinRouting::save(CheckpointWriter& writer) const {
+    writer.write(next);
+}
+
+bool RoundRobinRouting::restore(CheckpointReader& reader) {
+    if (reader.read(next) && next >= cNumberOfStations) {
+        next = 0;
+        return reader.fail("bad checkpoint routing state");
+    }
+    return reader.ok();
+}
+
+std::unique_ptr<RoutingPolicy> makeRoutingPolicy(StationRouting routing, StationIndex numberOfStations,
+                                                 const VertiportMap* map) {
+    switch (routing) {
+        case StationRouting::least_queued_routing:
+            return std::unique_ptr<RoutingPolicy>(new LeastQueuedRouting(numberOfStations));
+        case StationRouting::round_robin_routing:
+            return std::unique_ptr<RoutingPolicy>(new RoundRobinRouting(numberOfStations));
+        case StationRouting::nearest_routing:
+        default:
+            return std::unique_ptr<RoutingPolicy>(new NearestRouting(numberOfStations, map));
+    }
+}
+
+StationNetwork::StationNetwork(StationIndex numberOfStations, unsigned int numberOfChargingSlots, size_t fleetSize,
+                               std::unique_ptr<RoutingPolicy> policy, bool byNeed) :
+        policy(std::move(policy)),
+        vehicleStation(fleetSize),
+        isTouched(numberOfStations)
+{
+    assert(numberOfStations > 0);
+    stations.reserve(numberOfStations);
+    for (StationIndex s = 0; s < numberOfStations; ++s) {
+        stations.push_back(std::unique_ptr<FleetChargingStation>(
+                new FleetChargingStation(numberOfChargingSlots, byNeed, fleetSize)));
+    }
+    touched.reserve(numberOfStations);
+}
+
+void StationNetwork::touch(StationIndex station) {
+    if (!isTouched[station]) {
+        isTouched[station] = 1;
+        touched.push_back(station);
+    }
+}
+
+void StationNetwork::addVehicle(FleetState& fleet, VehicleIndex vehicle) {
+    assert(vehicle < vehicleStation.size());
+    StationIndex station = policy->route(fleet, vehicle);
+    assert(station < stations.size());
+    vehicleStation[vehicle] = station;
+    if (fleet.hasVertiports()) {
+        fleet.setVertiport(vehicle, station);
+    }
+
+    FleetChargingStation& chargingStation = *stations[station];
+    chargingStation.addVehicle(fleet, vehicle);
+    policy->loadChanged(station, chargingStation.getNumberCharging() + chargingStation.getNumberWaiting());
+    touch(station);
+}
+
+void StationNetwork::chargeComplete(VehicleIndex vehicle) {
+    touch(vehicleStation[vehicle]);
+}
+
+void StationNetwork::iterate(FleetState& fleet) {
+    for (StationIndex station : touched) {
+        FleetChargingStation& chargingStation = *stations[station];
+        chargingStation.iterate(fleet);
+        policy->loadChanged(station, chargingStation.getNumberCharging() + chargingStation.getNumberWaiting());
+        isTouched[station] = 0;
+    }
+    touched.clear();
+}
+
+void StationNetwork::reset() {
+    for (auto& station : stations) {
+        station->reset();
+    }
+    for (StationIndex station : touched) {
+        isTouched[station] = 0;
+    }
+    touched.clear();
+    policy->reset();
+}
+
+void StationNetwork::save(CheckpointWriter& writer) const {
+    assert(touched.empty());
+    writer.write(static_cast<uint32_t>(stations.size()));
+    for (const auto& station : stations) {
+        station->save(writer);
+    }
+    writer.writeArray(vehicleStation);
+    policy->save(writer);
+}
+
+bool StationNetwork::restore(CheckpointReader& reader, const FleetState& fleet) {
+    reset();
+    uint32_t numberOfStations = 0;
+    if (reader.read(numberOfStations) && numberOfStations != stations.size()) {
+        return reader.fail("checkpoint has " + std::to_string(numberOfStations) + " stations, the scenario has " +
+                           std::to_string(stations.size()));
+    }
+    for (auto& station : stations) {
+        if (!station->restore(reader, fleet.size())) {
+            reset();
+            return false;
+        }
+    }
+    reader.readArray(vehicleStation);
+    if (reader.ok() && vehicleStation.size() != fleet.size()) {
+        reader.fail("bad checkpoint station list");
+    }
+    for (size_t v = 0; v < vehicleStation.size() && reader.ok(); ++v) {
+        if (vehicleStation[v] >= stations.size()) {
+            reader.fail("bad checkpoint station list");
+        }
+    }
+    if (!reader.ok() || !policy->restore(reader)) {
+        reset();
+        return false;
+    }
+
+    // Load based policies rebuild from the station loads
+    for (StationIndex s = 0; s < stations.size(); ++s) {
+        policy->loadChanged(s, stations[s]->getNumberCharging() + stations[s]->getNumberWaiting());
+    }
+    return true;
+}
+
+StationIndex StationNetwork::size() const {
+    return static_cast<StationIndex>(stations.size());
+}
+
+const FleetChargingStation& StationNetwork::getStation(StationIndex station) const {
+    return *stations[station];
+}
+
+StationIndex StationNetwork::getVehicleStation(VehicleIndex vehicle) const {
+    return vehicleStation[vehicle];
+}
+
+size_t StationNetwork::getNumberCharging() const {
+    size_t charging = 0;
+    for (const auto& station : stations) {
+        charging += station->getNumberCharging();
+    }
+    return charging;
+}
+
+size_t StationNetwork::getNumberWaiting() const {
+    size_t waiting = 0;
+    for (const auto& station : stations) {
+        waiting += station->getNumberWaiting();
+    }
+    return waiting;
+}
+
+size_t StationNetwork::memoryUsage() const {
+    size_t bytes = sizeof(StationNetwork) + stations.capacity() * sizeof(stations[0]) +
+                   vehicleStation.capacity() * sizeof(StationIndex) + touched.capacity() * sizeof(StationIndex) +
+                   isTouched.capacity();
+    for (const auto& station : stations) {
+        bytes += station->memoryUsage();
+    }
+    return bytes;
+}
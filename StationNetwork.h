@@ -0,0 +1,146 @@
+#ifndef _STATION_NETWORK_H
+#define _STATION_NETWORK_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "./FleetChargingStation.h"
+#include "./FleetState.h"
+#include "./Geography.h"
+#include "./Scenario.h"
+
+// Index of a station in a StationNetwork
+typedef uint32_t StationIndex;
+
+// Chooses the station a vehicle queues at when it needs a charge
+class RoutingPolicy {
+public:
+    virtual ~RoutingPolicy() = default;
+
+    // Station for a vehicle of the fleet that just landed
+    virtual StationIndex route(const FleetState& fleet, VehicleIndex vehicle) = 0;
+
+    // Told whenever the number of vehicles charging or waiting at a station changes
+    virtual void loadChanged(StationIndex station, size_t load) {}
+
+    // Forget everything from a previous run, every station is empty again
+    virtual void reset() {}
+
+    // Write any state loadChanged() can't rebuild to a checkpoint, and read it back
+    virtual void save(CheckpointWriter& writer) const {}
+    virtual bool restore(CheckpointReader& reader) { return true; }
+};
+
+// The station nearest the vertiport a vehicle landed at, found in a NearestIndex over the station
+// vertiports (stations are at the first vertiports of the map, see VertiportMap). Well under a
+// microsecond for 10k stations. Without a map vehicles don't have positions, so each charges at a home
+// station handed out in turn (vehicle % stations) that stands in for the nearest one. O(1)
+class NearestRouting : public RoutingPolicy {
+private:
+    const StationIndex cNumberOfStations;
+    std::unique_ptr<NearestIndex> index;   // Null without a map
+
+public:
+    // map may be null, the fleet routed must have been given the same map (FleetState::enableVertiports())
+    explicit NearestRouting(StationIndex numberOfStations, const VertiportMap* map = nullptr);
+    StationIndex route(const FleetState& fleet, VehicleIndex vehicle) override;
+};
+
+// The station with the fewest vehicles charging or waiting, lowest index on ties. The stations are kept
+// in an indexed binary heap on their load, so routing is O(1) and a load change O(log stations).
+class LeastQueuedRouting : public RoutingPolicy {
+private:
+    vector<StationIndex> heap;       // Min heap of stations on (load, station)
+    vector<size_t> heapPosition;     // Position of each station in heap
+    vector<size_t> stationLoad;
+
+    bool lighter(StationIndex a, StationIndex b) const;
+    void swapPositions(size_t a, size_t b);
+
+public:
+    explicit LeastQueuedRouting(StationIndex numberOfStations);
+    StationIndex route(const FleetState& fleet, VehicleIndex vehicle) override;
+    void loadChanged(StationIndex station, size_t load) override;
+    void reset() override;
+};
+
+// Stations in turn. O(1)
+class RoundRobinRouting : public RoutingPolicy {
+private:
+    const StationIndex cNumberOfStations;
+    StationIndex next;
+
+public:
+    explicit RoundRobinRouting(StationIndex numberOfStations);
+    StationIndex route(const FleetState& fleet, VehicleIndex vehicle) override;
+    void reset() override;
+    void save(CheckpointWriter& writer) const override;
+    bool restore(CheckpointReader& reader) override;
+};
+
+// The built in policy for a routing setting. Nearest routing goes by distance on a map of vertiports if
+// there is one, the other policies don't look at where vehicles are.
+std::unique_ptr<RoutingPolicy> makeRoutingPolicy(StationRouting routing, StationIndex numberOfStations,
+                                                 const VertiportMap* map = nullptr);
+
+// A set of FleetChargingStations sharing one fleet. Landed vehicles are sent to the station the routing
+// policy picks, and only the stations that gained a vehicle or had a charge finish on a step are iterated,
+// so the cost of a step follows the number of state changes rather than the number of stations.
+class StationNetwork {
+private:
+    vector<std::unique_ptr<FleetChargingStation>> stations;
+    std::unique_ptr<RoutingPolicy> policy;
+
+    vector<StationIndex> vehicleStation;   // Station each vehicle last queued at, indexed by VehicleIndex
+
+    // Stations to iterate on this step, in the order they were touched
+    vector<StationIndex> touched;
+    vector<uint8_t> isTouched;
+
+    void touch(StationIndex station);
+
+public:
+    // numberOfStations stations with numberOfChargingSlots slots each, for a fleet of up to fleetSize.
+    // byNeed serves every station's queue by charge need (see FleetChargingStation).
+    StationNetwork(StationIndex numberOfStations, unsigned int numberOfChargingSlots, size_t fleetSize,
+                   std::unique_ptr<RoutingPolicy> policy, bool byNeed = false);
+
+    // Prevent unneeded defaults
+    StationNetwork(const StationNetwork&) = delete;
+    StationNetwork& operator=(const StationNetwork&) = delete;
+
+    // Route a vehicle that needs a charge to a station's wait queue. A fleet with vertiports moves the
+    // vehicle to the station's vertiport, which is the station index (see VertiportMap).
+    void addVehicle(FleetState& fleet, VehicleIndex vehicle);
+
+    // A vehicle finished charging, its station has a free slot
+    void chargeComplete(VehicleIndex vehicle);
+
+    // Iterate the stations that changed since the last iterate()
+    void iterate(FleetState& fleet);
+
+    // Empty every station and reset the routing policy
+    void reset();
+
+    // Write every station, the station of each vehicle and the routing policy state to a checkpoint.
+    // Only valid between iterate() calls, when no station is waiting to be iterated.
+    void save(CheckpointWriter& writer) const;
+
+    // Read back what save() wrote into a network built with the same number of stations, slots and
+    // routing, after the fleet has been restored. Returns false with the reason in the reader on a mismatch.
+    bool restore(CheckpointReader& reader, const FleetState& fleet);
+
+    StationIndex size() const;
+    const FleetChargingStation& getStation(StationIndex station) const;
+    StationIndex getVehicleStation(VehicleIndex vehicle) const;
+
+    // Totals over all the stations
+    size_t getNumberCharging() const;
+    size_t getNumberWaiting() const;
+
+    // Bytes allocated for the stations and the station of each vehicle
+    size_t memoryUsage() const;
+};
+
+#endif //_STATION_NETWORK_H
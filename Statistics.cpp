@@ -0,0 +1,123 @@
+#include <cassert>
+#include <cmath>
+#include <iomanip>
+#include <string>
+
+#include "./Checkpoint.h"
+#include "./Statistics.h"
+
+const double DurationSketch::cResolution = 1e-6;
+
+void DurationSketch::record(double minutes) {
+    assert(std::isfinite(minutes));
+    // Rounding can leave a duration that should be 0 a hair below it
+    histogram.record(minutes > 0.0 ? static_cast<uint64_t>(std::llround(minutes / cResolution)) : 0);
+}
+
+double DurationSketch::getTotal() const {
+    return static_cast<double>(histogram.getTotal()) * cResolution;
+}
+
+double DurationSketch::getMean() const {
+    return histogram.getMean() * cResolution;
+}
+
+double DurationSketch::getMinimum() const {
+    return static_cast<double>(histogram.getMinimum()) * cResolution;
+}
+
+double DurationSketch::getMaximum() const {
+    return static_cast<double>(histogram.getMaximum()) * cResolution;
+}
+
+double DurationSketch::percentile(double p) const {
+    return static_cast<double>(histogram.percentile(p)) * cResolution;
+}
+
+SessionStatistics::SessionStatistics(size_t numberOfModels) :
+        waits(numberOfModels),
+        charges(numberOfModels)
+{}
+
+void SessionStatistics::merge(const SessionStatistics& other) {
+    assert(other.numberOfModels() == numberOfModels());
+    for (size_t m = 0; m < waits.size(); ++m) {
+        waits[m].merge(other.waits[m]);
+        charges[m].merge(other.charges[m]);
+    }
+}
+
+void SessionStatistics::clear() {
+    for (size_t m = 0; m < waits.size(); ++m) {
+        waits[m].clear();
+        charges[m].clear();
+    }
+}
+
+void SessionStatistics::save(CheckpointWriter& writer) const {
+    writer.write(static_cast<uint32_t>(waits.size()));
+    for (size_t m = 0; m < waits.size(); ++m) {
+        waits[m].save(writer);
+        charges[m].save(writer);
+    }
+}
+
+bool SessionStatistics::restore(CheckpointReader& reader) {
+    uint32_t models = 0;
+    reader.read(models);
+    if (reader.ok() && models != waits.size()) {
+        return reader.fail("checkpoint has sessions of " + std::to_string(models) + " models, the scenario has " +
+                           std::to_string(waits.size()));
+    }
+    for (size_t m = 0; m < waits.size() && reader.ok(); ++m) {
+        waits[m].restore(reader);
+        charges[m].restore(reader);
+    }
+    return reader.ok();
+}
+
+DurationSketch SessionStatistics::allWaits() const {
+    DurationSketch all;
+    for (const DurationSketch& sketch : waits) {
+        all.merge(sketch);
+    }
+    return all;
+}
+
+DurationSketch SessionStatistics::allCharges() const {
+    DurationSketch all;
+    for (const DurationSketch& sketch : charges) {
+        all.merge(sketch);
+    }
+    return all;
+}
+
+namespace {
+
+void printSketch(std::ostream& out, const std::string& name, const DurationSketch& sketch) {
+    out << "  " << name << ": " << sketch.getCount() << "/" << sketch.getMean() << "/" << sketch.percentile(0.5)
+        << "/" << sketch.percentile(0.9) << "/" << sketch.percentile(0.95) << "/" << sketch.percentile(0.99)
+        << "/" << sketch.getMaximum() << "\n";
+}
+
+}
+
+void SessionStatistics::print(std::ostream& out, const vector<ModelParameters>& models) const {
+    assert(models.size() == numberOfModels());
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "Sessions, model: count/mean/p50/p90/p95/p99/max(mins)\n";
+    for (size_t m = 0; m < models.size(); ++m) {
+        if (waits[m].getCount() > 0) {
+            printSketch(out, models[m].label + " wait", waits[m]);
+        }
+        if (charges[m].getCount() > 0) {
+            printSketch(out, models[m].label + " charge", charges[m]);
+        }
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,79 @@
+#ifndef _STATISTICS_H
+#define _STATISTICS_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "./Histogram.h"
+#include "./Vehicle.h"
+
+using std::vector;
+
+// Distribution of durations in world time minutes, kept in a LatencyHistogram of cResolution minute
+// units: every duration to within 1 part in 128, in a fixed size table whatever the number recorded.
+// Sketches merge exactly and in any order, so sketches filled on different threads or by different
+// replications combine into the same result however the work was split.
+class DurationSketch {
+private:
+    LatencyHistogram histogram;
+
+public:
+    // Minutes per histogram unit, shorter durations are recorded as 0
+    static const double cResolution;
+
+    void record(double minutes);
+    void merge(const DurationSketch& other) { histogram.merge(other.histogram); }
+    void clear() { histogram.clear(); }
+
+    void save(CheckpointWriter& writer) const { histogram.save(writer); }
+    bool restore(CheckpointReader& reader) { return histogram.restore(reader); }
+
+    uint64_t getCount() const { return histogram.getCount(); }
+    double getTotal() const;
+    double getMean() const;
+    double getMinimum() const;
+    double getMaximum() const;
+
+    // The duration below which the fraction p (0 to 1) of the recorded durations fall, 0 when nothing
+    // has been recorded
+    double percentile(double p) const;
+};
+
+// Per model distributions of the completed charging sessions of a run and of the waits for a charger
+// before each one (0 for a vehicle that found a free charger). Filled in by FleetState::recordSessions().
+class SessionStatistics {
+private:
+    vector<DurationSketch> waits;     // Indexed by model
+    vector<DurationSketch> charges;
+
+public:
+    explicit SessionStatistics(size_t numberOfModels);
+
+    size_t numberOfModels() const { return waits.size(); }
+
+    void recordWait(size_t model, double minutes) { waits[model].record(minutes); }
+    void recordCharge(size_t model, double minutes) { charges[model].record(minutes); }
+
+    // Add in the sessions of another run of the same models
+    void merge(const SessionStatistics& other);
+    void clear();
+
+    // Write the sketches of every model to a checkpoint, and read them back into statistics of the same
+    // number of models. restore() returns false with the reason in the reader on a mismatch.
+    void save(CheckpointWriter& writer) const;
+    bool restore(CheckpointReader& reader);
+
+    const DurationSketch& getWaits(size_t model) const { return waits[model]; }
+    const DurationSketch& getCharges(size_t model) const { return charges[model]; }
+
+    // Sessions of every model together
+    DurationSketch allWaits() const;
+    DurationSketch allCharges() const;
+
+    // Print count, mean, percentiles and maximum of the waits and charges of each model that has any,
+    // models are in model index order for their labels
+    void print(std::ostream& out, const vector<ModelParameters>& models) const;
+};
+
+#endif //_STATISTICS_H
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+#include "./Sweep.h"
+#include "./FleetSimulation.h"
+#include "./Simulation.h"
+
+using std::cout;
+
+namespace {
+
+void clearTotals(VehicleModelMap& modelStates) {
+    for (auto model : modelStates) {
+        model.second->resetTotals();
+    }
+}
+
+}
+
+std::vector<SweepCell> sweepCells(const Scenario& scenario) {
+    std::vector<unsigned int> chargers = scenario.sweepChargers;
+    if (chargers.empty()) {
+        chargers.push_back(static_cast<unsigned int>(scenario.numberOfChargingSlots));
+    }
+    std::vector<unsigned int> fleetSizes = scenario.sweepFleetSizes;
+    if (fleetSizes.empty()) {
+        fleetSizes.push_back(scenario.fleetSize);
+    }
+    std::vector<std::vector<double>> weights = scenario.sweepWeights;
+    if (weights.empty()) {
+        weights.push_back(scenario.modelWeights);
+    }
+
+    std::vector<SweepCell> cells;
+    for (const std::vector<double>& modelWeights : weights) {
+        for (unsigned int fleetSize : fleetSizes) {
+            for (unsigned int slots : chargers) {
+                cells.push_back({slots, fleetSize, modelWeights});
+            }
+        }
+    }
+    return cells;
+}
+
+SweepResult runSweepCell(const Scenario& scenario, const SweepCell& cell) {
+    VehicleModelMap modelStates;
+    initializeModels(scenario, modelStates);
+    FleetState fleet(modelList(modelStates));
+    fleet.keepVehicleTotals(false);
+    shared_ptr<const VertiportMap> vertiports = makeVertiportMap(scenario);
+    enableFleetModels(scenario, scenario.seed, fleet, vertiports);
+    generateFleet(cell.modelWeights, cell.fleetSize, scenario.seed, fleet);
+    StationNetwork stations(scenario.numberOfStations, cell.numberOfChargingSlots, cell.fleetSize,
+                            makeRoutingPolicy(scenario.routing, scenario.numberOfStations, vertiports.get()),
+                            scenario.battery);
+    ThreadPool pool(1); // Single threaded, cells are the unit of parallel work
+
+    // Run in pieces, each carrying on from the clock of the last one, with a look at the waits in between
+    bool checking = std::isfinite(scenario.sweepMaxWait);
+    unsigned int pieces = checking ? cSweepChecks : 1;
+    FleetCheckpoint piece{FleetClock{0.0, 0}, "", 0.0};
+    bool saturated = false;
+    for (unsigned int p = 1; p <= pieces && !saturated; ++p) {
+        // The model totals are summed from scratch at the end of each piece
+        clearTotals(modelStates);
+        double pieceEnd = p == pieces ? scenario.runTime : scenario.runTime * p / pieces;
+        piece.start.totalIterations = runFleetLoop(fleet, stations, nullptr, scenario.increment, pieceEnd, pool,
+                                                   nullptr, &piece);
+        piece.start.currentTime = static_cast<double>(piece.start.totalIterations) * scenario.increment;
+
+        double totalWaitingTime = 0.0;
+        for (auto model : modelStates) {
+            totalWaitingTime += model.second->totalWaitingTime;
+        }
+        saturated = p < pieces && totalWaitingTime > scenario.sweepMaxWait * cell.fleetSize;
+    }
+
+    SweepResult result{cell, saturated, piece.start.currentTime, 0.0, {}};
+    double totalWaitingTime = 0.0;
+    for (auto model : modelStates) {
+        const ModelData& data = *model.second;
+        double fleetCount = data.fleetCount > 0 ? data.fleetCount : std::numeric_limits<double>::quiet_NaN();
+        result.models.push_back({data.fleetCount,
+                                 data.totalFlightTime / fleetCount,
+                                 data.totalWaitingTime / fleetCount,
+                                 data.totalChargingTime / fleetCount,
+                                 data.params.cruiseSpeed * (data.totalFlightTime / 60.0) * data.params.passengerCount});
+        totalWaitingTime += data.totalWaitingTime;
+    }
+    result.averageWaitingTime = cell.fleetSize > 0 ? totalWaitingTime / cell.fleetSize : 0.0;
+    return result;
+}
+
+std::vector<SweepResult> runSweepCells(const Scenario& scenario, ThreadPool& pool) {
+    std::vector<SweepCell> cells = sweepCells(scenario);
+    std::vector<SweepResult> results(cells.size());
+
+    // Hand out the largest fleets first so a big cell doesn't start last and hold up the end of the sweep
+    std::vector<size_t> order(cells.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&cells](size_t a, size_t b) {
+        return cells[a].fleetSize > cells[b].fleetSize;
+    });
+
+    pool.run(cells.size(), [&](size_t task) {
+        size_t c = order[task];
+        results[c] = runSweepCell(scenario, cells[c]);
+    });
+    return results;
+}
+
+void writeSweepCsv(std::ostream& out, const Scenario& scenario, const std::vector<SweepResult>& results) {
+    out << "chargers,fleet_size,weights,saturated,run_time,average_waiting";
+    for (const ModelParameters& model : scenario.models) {
+        out << "," << model.label << "_vehicles," << model.label << "_flight," << model.label << "_waiting,"
+            << model.label << "_charging," << model.label << "_passenger_miles";
+    }
+    out << "\n";
+
+    for (const SweepResult& result : results) {
+        out << result.cell.numberOfChargingSlots << "," << result.cell.fleetSize << ",";
+        for (size_t m = 0; m < result.cell.modelWeights.size(); ++m) {
+            out << (m > 0 ? " " : "") << result.cell.modelWeights[m];
+        }
+        out << "," << (result.saturated ? 1 : 0) << "," << result.runTime << "," << result.averageWaitingTime;
+        for (const SweepModelResult& model : result.models) {
+            out << "," << model.fleetCount << "," << model.averageFlightTime << "," << model.averageWaitingTime
+                << "," << model.averageChargingTime << "," << model.totalPassengerMiles;
+        }
+        out << "\n";
+    }
+    out << std::flush;
+}
+
+bool runSweep(const Scenario& scenario, std::string& error) {
+    std::ofstream file;
+    if (!scenario.sweepOutput.empty()) {
+        file.open(scenario.sweepOutput, std::ios::trunc);
+        if (!file) {
+            error = scenario.sweepOutput + ": can't open sweep output file";
+            return false;
+        }
+    }
+
+    ThreadPool pool(scenario.numberOfThreads);
+    double startTime = sysTime();
+    std::vector<SweepResult> results = runSweepCells(scenario, pool);
+    double totalRunTime = sysTime() - startTime;
+
+    writeSweepCsv(scenario.sweepOutput.empty() ? cout : file, scenario, results);
+    if (file.is_open() && !file) {
+        error = scenario.sweepOutput + ": can't write sweep output file";
+        return false;
+    }
+
+    unsigned long saturated = 0;
+    for (const SweepResult& result : results) {
+        saturated += result.saturated;
+    }
+    std::cerr << "Sweep finished, cells/saturated/threads/total-run-time(seconds): " << results.size() << "/"
+              << saturated << "/" << pool.size() << "/" << totalRunTime << std::endl;
+    std::cerr << "Seed: " << scenario.seed << std::endl;
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef _SWEEP_H
+#define _SWEEP_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "./Scenario.h"
+#include "./ThreadPool.h"
+
+// One combination of swept settings
+struct SweepCell {
+    unsigned int numberOfChargingSlots;  // Per station
+    unsigned int fleetSize;
+    std::vector<double> modelWeights;
+};
+
+// Per model results of a sweep run
+struct SweepModelResult {
+    unsigned int fleetCount;
+    double averageFlightTime;     // minutes per vehicle
+    double averageWaitingTime;    // minutes per vehicle
+    double averageChargingTime;   // minutes per vehicle
+    double totalPassengerMiles;
+};
+
+struct SweepResult {
+    SweepCell cell;
+    bool saturated;               // Stopped early because the average wait was already past scenario.sweepMaxWait
+    double runTime;               // World time minutes simulated, less than scenario.runTime when saturated
+    double averageWaitingTime;    // minutes per vehicle, over the whole fleet
+    std::vector<SweepModelResult> models;
+};
+
+// Every combination of the scenario's sweep lists, a list that is empty takes the single setting instead.
+// Charging slots vary fastest, then fleet size, then model weights.
+std::vector<SweepCell> sweepCells(const Scenario& scenario);
+
+// Number of times during a run a sweep checks for saturation
+const unsigned int cSweepChecks = 32;
+
+// Run one combination with the fleet engine and a fixed increment, on the calling thread. The cell has
+// its own model records, fleet and stations, and every cell uses scenario.seed so cells differ only in
+// their settings. With a scenario.sweepMaxWait the waiting time of the fleet is checked cSweepChecks
+// times during the run: once the completed waits are past sweepMaxWait per vehicle the final average is
+// sure to be too, so the run stops there and is marked saturated.
+SweepResult runSweepCell(const Scenario& scenario, const SweepCell& cell);
+
+// Run every cell of a sweep across the pool, largest fleets first, returns the results in sweepCells()
+// order. Results don't depend on the pool.
+std::vector<SweepResult> runSweepCells(const Scenario& scenario, ThreadPool& pool);
+
+// Write the results as CSV with a header row, a row per cell:
+//   chargers,fleet_size,weights,saturated,run_time,average_waiting,
+//   then per model <label>_vehicles,<label>_flight,<label>_waiting,<label>_charging,<label>_passenger_miles
+// The weights are space separated, times are minutes per vehicle.
+void writeSweepCsv(std::ostream& out, const Scenario& scenario, const std::vector<SweepResult>& results);
+
+// Run the sweep of a scenario on scenario.numberOfThreads threads and write the results to
+// scenario.sweepOutput, or standard output. Returns false with a message in error if the output file
+// can't be written.
+bool runSweep(const Scenario& scenario, std::string& error);
+
+#endif //_SWEEP_H
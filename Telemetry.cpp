@@ -0,0 +1,186 @@
+#include <cstdio>
+#include <cstring>
+
+#include "./Telemetry.h"
+
+namespace {
+
+const char cMagic[8] = {'J', 'O', 'B', 'Y', 'T', 'L', 'M', '\0'};
+const uint32_t cVersion = 1;
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}
+
+Telemetry::Telemetry(const std::string& path, double interval, const vector<shared_ptr<ModelData>>& models) :
+        cInterval(interval),
+        nextSampleTime(0.0),
+        cCsv(endsWith(path, ".csv")),
+        models(models),
+        file(path, std::ios::binary | std::ios::trunc),
+        blocks(cNumberOfBlocks),
+        currentBlock(0),
+        fullBlocks(cNumberOfBlocks),
+        emptyBlocks(cNumberOfBlocks),
+        stopping(false)
+{
+    for (size_t b = 0; b < cNumberOfBlocks; ++b) {
+        blocks[b].reserve(cBlockSize);
+        if (b != currentBlock) {
+            emptyBlocks.push(b);
+        }
+    }
+    if (!file) {
+        return;
+    }
+    writeHeader();
+    writer = std::thread(&Telemetry::writeLoop, this);
+}
+
+Telemetry::~Telemetry() {
+    if (!writer.joinable()) {
+        return;
+    }
+    handOff();
+    {
+        std::lock_guard<std::mutex> lock(blockMutex);
+        stopping = true;
+    }
+    blockFull.notify_one();
+    writer.join();
+}
+
+bool Telemetry::isOpen() const {
+    return static_cast<bool>(file);
+}
+
+// Copy into the current block, handing it to the writer when it fills up
+void Telemetry::append(const void* data, size_t size) {
+    vector<char>& block = blocks[currentBlock];
+    if (block.size() + size > cBlockSize) {
+        handOff();
+    }
+    const char* bytes = static_cast<const char*>(data);
+    blocks[currentBlock].insert(blocks[currentBlock].end(), bytes, bytes + size);
+}
+
+void Telemetry::handOff() {
+    std::unique_lock<std::mutex> lock(blockMutex);
+    fullBlocks.push(currentBlock);
+    blockFull.notify_one();
+    // Only waits when the writer has fallen a whole set of blocks behind
+    blockEmpty.wait(lock, [this] { return !emptyBlocks.empty(); });
+    currentBlock = emptyBlocks.front();
+    emptyBlocks.pop();
+}
+
+void Telemetry::writeLoop() {
+    std::unique_lock<std::mutex> lock(blockMutex);
+    for (;;) {
+        blockFull.wait(lock, [this] { return stopping || !fullBlocks.empty(); });
+        if (fullBlocks.empty()) {
+            break;
+        }
+        size_t b = fullBlocks.front();
+        fullBlocks.pop();
+
+        lock.unlock();
+        file.write(blocks[b].data(), static_cast<std::streamsize>(blocks[b].size()));
+        blocks[b].clear();
+        lock.lock();
+
+        emptyBlocks.push(b);
+        blockEmpty.notify_one();
+    }
+    file.flush();
+}
+
+void Telemetry::writeHeader() {
+    if (cCsv) {
+        std::string header = "time";
+        for (unsigned int state = 0; state < cNumberOfOperationStates; ++state) {
+            header += std::string(",") + operationStateName(state);
+        }
+        header += ",queue_length,chargers_in_use";
+        for (const shared_ptr<ModelData>& model : models) {
+            header += "," + model->params.label + "_flight," + model->params.label + "_charging," +
+                      model->params.label + "_waiting";
+        }
+        header += "\n";
+        append(header.data(), header.size());
+        return;
+    }
+
+    uint32_t counts[3] = {cVersion, cNumberOfOperationStates, static_cast<uint32_t>(models.size())};
+    append(cMagic, sizeof(cMagic));
+    append(counts, sizeof(counts));
+    for (const shared_ptr<ModelData>& model : models) {
+        uint32_t length = static_cast<uint32_t>(model->params.label.size());
+        append(&length, sizeof(length));
+        append(model->params.label.data(), length);
+    }
+}
+
+void Telemetry::writeSample(double time, uint64_t waiting, uint64_t charging) {
+    // Catch up without writing the samples skipped by a long step
+    while (nextSampleTime <= time) {
+        nextSampleTime += cInterval;
+    }
+
+    if (!cCsv) {
+        append(&time, sizeof(time));
+        append(stateCounts.data(), stateCounts.size() * sizeof(uint64_t));
+        append(&waiting, sizeof(waiting));
+        append(&charging, sizeof(charging));
+        for (const ModelTotals& totals : modelTotals) {
+            double values[3] = {totals.totalFlightTime, totals.totalChargingTime, totals.totalWaitingTime};
+            append(values, sizeof(values));
+        }
+        return;
+    }
+
+    char field[32];
+    int length = std::snprintf(field, sizeof(field), "%.10g", time);
+    append(field, static_cast<size_t>(length));
+    for (uint64_t count : stateCounts) {
+        length = std::snprintf(field, sizeof(field), ",%llu", static_cast<unsigned long long>(count));
+        append(field, static_cast<size_t>(length));
+    }
+    length = std::snprintf(field, sizeof(field), ",%llu,%llu",
+                           static_cast<unsigned long long>(waiting), static_cast<unsigned long long>(charging));
+    append(field, static_cast<size_t>(length));
+    for (const ModelTotals& totals : modelTotals) {
+        length = std::snprintf(field, sizeof(field), ",%.10g", totals.totalFlightTime);
+        append(field, static_cast<size_t>(length));
+        length = std::snprintf(field, sizeof(field), ",%.10g", totals.totalChargingTime);
+        append(field, static_cast<size_t>(length));
+        length = std::snprintf(field, sizeof(field), ",%.10g", totals.totalWaitingTime);
+        append(field, static_cast<size_t>(length));
+    }
+    append("\n", 1);
+}
+
+void Telemetry::record(double time, const FleetState& fleet, const StationNetwork& stations) {
+    fleet.sample(stateCounts, modelTotals);
+    writeSample(time, stations.getNumberWaiting(), stations.getNumberCharging());
+}
+
+void Telemetry::record(double time, const vector<shared_ptr<Vehicle>>& vehicles,
+                       const ChargingStation& chargingStation) {
+    sampleVehicles(vehicles, models, stateCounts, modelTotals);
+    writeSample(time, chargingStation.getNumberWaiting(), chargingStation.getNumberCharging());
+}
+
+void sampleVehicles(const vector<shared_ptr<Vehicle>>& vehicles, const vector<shared_ptr<ModelData>>& models,
+                    vector<uint64_t>& stateCounts, vector<ModelTotals>& modelTotals) {
+    stateCounts.assign(cNumberOfOperationStates, 0);
+    for (const shared_ptr<Vehicle>& v : vehicles) {
+        ++stateCounts[v->getOpState()];
+    }
+    modelTotals.resize(models.size());
+    for (size_t m = 0; m < models.size(); ++m) {
+        modelTotals[m] = {models[m]->totalFlightTime, models[m]->totalChargingTime, models[m]->totalWaitingTime, 0.0, 0};
+    }
+}
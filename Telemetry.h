@@ -0,0 +1,94 @@
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "./ChargingStation.h"
+#include "./FleetState.h"
+#include "./RingBuffer.h"
+#include "./StationNetwork.h"
+#include "./Vehicle.h"
+
+// Opt-in time series of a run, sampled every interval of world time: the number of vehicles in each
+// OperationState, the number of vehicles waiting for and using a charger, and the per model totals so far.
+//
+// Samples are encoded on the simulation thread into fixed size blocks and a background thread writes
+// the full blocks to the file, so the simulation only waits on the disk when every block is full.
+//
+// A path ending in ".csv" gets a CSV file with a header row. Anything else gets a native endian binary
+// file: an 8 byte "JOBYTLM" magic, then uint32 version, number of states and number of models, then each
+// model label as a uint32 length and its characters, followed by fixed size records of
+//   double time, uint64 count per state, uint64 waiting, uint64 charging,
+//   per model double flight, charging and waiting minutes.
+class Telemetry {
+private:
+    static const size_t cBlockSize = 64 * 1024;
+    static const size_t cNumberOfBlocks = 8;
+
+    const double cInterval;
+    double nextSampleTime;
+    const bool cCsv;
+
+    // Model records in ModelIndex order, read by the Vehicle based record()
+    vector<shared_ptr<ModelData>> models;
+
+    // Scratch space for one sample
+    vector<uint64_t> stateCounts;
+    vector<ModelTotals> modelTotals;
+
+    std::ofstream file;
+
+    // Blocks are handed from the simulation thread to the writer thread and back through the two queues
+    vector<vector<char>> blocks;
+    size_t currentBlock;
+    RingBuffer<size_t> fullBlocks;
+    RingBuffer<size_t> emptyBlocks;
+    bool stopping;
+    std::mutex blockMutex;
+    std::condition_variable blockFull;
+    std::condition_variable blockEmpty;
+    std::thread writer;
+
+    void append(const void* data, size_t size);
+    void handOff();
+    void writeLoop();
+
+    void writeHeader();
+    void writeSample(double time, uint64_t waiting, uint64_t charging);
+
+public:
+    // Open path for writing, check isOpen() before use
+    Telemetry(const std::string& path, double interval, const vector<shared_ptr<ModelData>>& models);
+
+    // Writes out the last block
+    ~Telemetry();
+
+    // Prevent unneeded defaults
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    bool isOpen() const;
+
+    // True when a sample should be taken at world time
+    bool isDue(double time) const { return time >= nextSampleTime; }
+    double getNextSampleTime() const { return nextSampleTime; }
+
+    // Take a sample of a fleet engine run
+    void record(double time, const FleetState& fleet, const StationNetwork& stations);
+
+    // Take a sample of a tick engine run, the model totals come from the shared ModelData records
+    void record(double time, const vector<shared_ptr<Vehicle>>& vehicles, const ChargingStation& chargingStation);
+};
+
+// The tick engine's counterpart of FleetState::sample(): the number of vehicles in each OperationState
+// and the model totals so far, from the shared ModelData records in model index order
+void sampleVehicles(const vector<shared_ptr<Vehicle>>& vehicles, const vector<shared_ptr<ModelData>>& models,
+                    vector<uint64_t>& stateCounts, vector<ModelTotals>& modelTotals);
+
+#endif //_TELEMETRY_H
@@ -0,0 +1,88 @@
+#include <algorithm>
+
+#include "./ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int numberOfThreads) :
+        task(nullptr),
+        numberOfTasks(0),
+        nextTask(0),
+        batch(0),
+        busyWorkers(0),
+        stopping(false)
+{
+    if (numberOfThreads == 0) {
+        numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // The calling thread is the first of the pool
+    for (unsigned int i = 1; i < numberOfThreads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startBatch.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned int ThreadPool::size() const {
+    return static_cast<unsigned int>(workers.size() + 1);
+}
+
+// Claim and run tasks until there are none left in the current batch
+void ThreadPool::runTasks() {
+    for (size_t t = nextTask++; t < numberOfTasks; t = nextTask++) {
+        (*task)(t);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    unsigned long lastBatch = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        startBatch.wait(lock, [&] { return stopping || batch != lastBatch; });
+        if (stopping) {
+            return;
+        }
+        lastBatch = batch;
+
+        lock.unlock();
+        runTasks();
+        lock.lock();
+
+        if (--busyWorkers == 0) {
+            batchDone.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run(size_t tasks, const std::function<void(size_t)>& taskFunction) {
+    if (workers.empty() || tasks <= 1) {
+        for (size_t t = 0; t < tasks; ++t) {
+            taskFunction(t);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &taskFunction;
+        numberOfTasks = tasks;
+        nextTask = 0;
+        busyWorkers = static_cast<unsigned int>(workers.size());
+        ++batch;
+    }
+    startBatch.notify_all();
+
+    runTasks();
+
+    // Workers still reference the task until they check in
+    std::unique_lock<std::mutex> lock(mutex);
+    batchDone.wait(lock, [&] { return busyWorkers == 0; });
+    task = nullptr;
+}
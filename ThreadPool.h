@@ -0,0 +1,52 @@
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run batches of numbered tasks.
+//
+// run() hands out task numbers 0..numberOfTasks-1 to the workers (and the calling thread) and returns
+// once all of them are done. Which thread runs which task isn't fixed, so callers that need repeatable
+// results key their partial results by task number and combine them in task order.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable startBatch;
+    std::condition_variable batchDone;
+
+    // Current batch, guarded by mutex except for the atomic task counter
+    const std::function<void(size_t)>* task;
+    size_t numberOfTasks;
+    std::atomic<size_t> nextTask;
+    unsigned long batch;          // Incremented for every run() so workers can tell batches apart
+    unsigned int busyWorkers;
+    bool stopping;
+
+    void workerLoop();
+    void runTasks();
+
+public:
+    // numberOfThreads includes the thread calling run(), 0 uses one thread per hardware core
+    explicit ThreadPool(unsigned int numberOfThreads);
+
+    // Disable unneeded defaults
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+    // Number of threads that run tasks, including the caller
+    unsigned int size() const;
+
+    // Run task(0) .. task(numberOfTasks-1) across the pool and wait for them to finish
+    void run(size_t numberOfTasks, const std::function<void(size_t)>& task);
+};
+
+#endif //_THREAD_POOL_H
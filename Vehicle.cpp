@@ -1,9 +1,23 @@
+#include <cassert>
 #include <iostream>
+#include <limits>
 
+#include "./Profiler.h"
 #include "./Vehicle.h"
 
 using std::cout;
-using std::endl;
+
+namespace {
+
+const char* const cStateNames[cNumberOfOperationStates] = {
+        "en_route", "waiting_for_charge_queue", "in_charge_queue", "charging", "grounded", "parked"};
+
+}
+
+const char* operationStateName(unsigned int state) {
+    assert(state < cNumberOfOperationStates);
+    return cStateNames[state];
+}
 
 Vehicle::Vehicle(shared_ptr<ModelData> modelData) :
         modelState(modelData),
@@ -21,6 +35,7 @@ Vehicle::~Vehicle() {
 
 // Implementation of ICharging interface
 void Vehicle::setCharging() {
+    PROFILE_TRANSITION(modelState.get(), operationState, OperationState::charging);
     operationState = OperationState::charging;
     currentOperationTime = 0;
 }
@@ -34,6 +49,7 @@ bool Vehicle::isWaitingForQueue() const {
 }
 
 void Vehicle::setInWaitQueue() {
+    PROFILE_TRANSITION(modelState.get(), operationState, OperationState::in_charge_queue);
     operationState = OperationState::in_charge_queue;
 }
 
@@ -42,11 +58,12 @@ OperationState Vehicle::getOpState() const {
 }
 
 // Iterate by delta-time in seconds (simulated minutes)
-void Vehicle::iterate(double deltaT) {
+double Vehicle::iterate(double deltaT) {
     double newOperationTime = currentOperationTime + deltaT;
     switch (operationState) {
         case en_route: {
-            if (newOperationTime >= modelState->params.endurance) {
+            if (newOperationTime + cOperationTimeTolerance >= modelState->params.endurance) {
+                PROFILE_TRANSITION(modelState.get(), en_route, waiting_for_charge_queue);
                 operationState = OperationState::waiting_for_charge_queue; //This is an intermediate state
                 // Reset operation time - there may be an overrun
                 currentOperationTime = 0;
@@ -74,7 +91,8 @@ void Vehicle::iterate(double deltaT) {
             break;
         };
         case charging: {
-            if (newOperationTime >= modelState->params.timeToCharge) {
+            if (newOperationTime + cOperationTimeTolerance >= modelState->params.timeToCharge) {
+                PROFILE_TRANSITION(modelState.get(), charging, en_route);
                 operationState = OperationState::en_route;
                 // Reset operation time - there may be an overrun
                 currentOperationTime = 0;
@@ -88,28 +106,110 @@ void Vehicle::iterate(double deltaT) {
             }
             break;
         };
+        case grounded: {
+            // Faults are only simulated by the fleet engine
+            break;
+        };
+        case parked: {
+            // Demand is only simulated by the fleet engine
+            break;
+        };
+    };
+    return timeRemaining();
+}
 
+double Vehicle::timeRemaining() const {
+    switch (operationState) {
+        case en_route:
+            return modelState->params.endurance - currentOperationTime;
+        case charging:
+            return modelState->params.timeToCharge - currentOperationTime;
+        default:
+            return std::numeric_limits<double>::infinity();
+    }
+}
+
+// Advance by delta-time in simulated minutes, the operation completes when deltaT reaches timeRemaining()
+void Vehicle::advance(double deltaT) {
+    bool complete = deltaT >= timeRemaining();
+    switch (operationState) {
+        case en_route: {
+            totalTimeEnRoute += deltaT;
+            modelState->totalFlightTime += deltaT;
+            currentOperationTime += deltaT;
+            if (complete) {
+                PROFILE_TRANSITION(modelState.get(), en_route, waiting_for_charge_queue);
+                operationState = OperationState::waiting_for_charge_queue;
+                currentOperationTime = 0;
+            }
+            break;
+        };
+        case waiting_for_charge_queue: {
+            // Same as iterate(), the vehicle is handed to the charging station before time moves on
+            break;
+        };
+        case in_charge_queue: {
+            addWaitTime(deltaT);
+            break;
+        };
+        case charging: {
+            totalTimeCharging += deltaT;
+            modelState->totalChargingTime += deltaT;
+            currentOperationTime += deltaT;
+            if (complete) {
+                PROFILE_TRANSITION(modelState.get(), charging, en_route);
+                operationState = OperationState::en_route;
+                currentOperationTime = 0;
+            }
+            break;
+        };
+        case grounded:
+        case parked: {
+            break;
+        };
     };
 }
 
+void Vehicle::addWaitTime(double deltaT) {
+    totalTimeWaiting += deltaT;  // Total for vehicle (sim minutes)
+    modelState->totalWaitingTime += deltaT; // Total for model (sim minutes)
+}
+
 void Vehicle::printResult() const {
-    cout << "Result: " << endl;
-    cout << "  Model                      : " << modelState->params.label << endl;
-    cout << "  Endurance                  : " << modelState->params.endurance << endl;
-    cout << "  Total Time In Flight (mins): " << totalTimeEnRoute << endl;
-    cout << "  Total Time Charging (mins) : " << totalTimeCharging << endl;
-    cout << "  Total Time Waiting (mins)  : " << totalTimeWaiting << endl;
-    cout << "  Total Passenger Miles      : " << (totalTimeEnRoute / 60.0) * modelState->params.cruiseSpeed * modelState->params.passengerCount << endl;
+    cout << "Result: \n";
+    cout << "  Model                      : " << modelState->params.label << "\n";
+    cout << "  Endurance                  : " << modelState->params.endurance << "\n";
+    cout << "  Total Time In Flight (mins): " << totalTimeEnRoute << "\n";
+    cout << "  Total Time Charging (mins) : " << totalTimeCharging << "\n";
+    cout << "  Total Time Waiting (mins)  : " << totalTimeWaiting << "\n";
+    cout << "  Total Passenger Miles      : " << (totalTimeEnRoute / 60.0) * modelState->params.cruiseSpeed * modelState->params.passengerCount << "\n";
 }
 
 void ModelData::prinResult() {
     double totalPassengerMiles = params.cruiseSpeed * (totalFlightTime/60.0) *params.passengerCount;
-    cout << params.label << " Results: " << endl;
-    cout << "   Number of Vehicle            : " << fleetCount << endl;
-    cout << "   Average Time in Flight (mins): " << totalFlightTime/fleetCount << endl;
-    cout << "   Average Time Waiting (mins)  : " << totalWaitingTime/fleetCount << endl;
-    cout << "   Average Time Charging (mins) : " << totalChargingTime/fleetCount << endl;
-    cout << "   Max number of faults         : " << params.MaxFaultsPerHour * (totalFlightTime/60.0) << endl;
-    cout << "   Total Passenger Miles        : " << totalPassengerMiles << endl;
-    cout << "   Average Passenger Miles      : " << totalPassengerMiles/fleetCount << endl;
+    cout << params.label << " Results: \n";
+    cout << "   Number of Vehicle            : " << fleetCount << "\n";
+    cout << "   Average Time in Flight (mins): " << totalFlightTime/fleetCount << "\n";
+    cout << "   Average Time Waiting (mins)  : " << totalWaitingTime/fleetCount << "\n";
+    cout << "   Average Time Charging (mins) : " << totalChargingTime/fleetCount << "\n";
+    cout << "   Max number of faults         : " << params.MaxFaultsPerHour * (totalFlightTime/60.0) << "\n";
+    if (totalFaults > 0) {
+        cout << "   Number of faults             : " << totalFaults << "\n";
+        cout << "   Average Time Grounded (mins) : " << totalGroundedTime/fleetCount << "\n";
+    }
+    cout << "   Total Passenger Miles        : " << totalPassengerMiles << "\n";
+    cout << "   Average Passenger Miles      : " << totalPassengerMiles/fleetCount << "\n";
+}
+
+void ModelData::reset() {
+    fleetCount = 0;
+    resetTotals();
+}
+
+void ModelData::resetTotals() {
+    totalFlightTime = 0;
+    totalChargingTime = 0;
+    totalWaitingTime = 0;
+    totalGroundedTime = 0;
+    totalFaults = 0;
 }
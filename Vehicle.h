@@ -1,6 +1,9 @@
 #ifndef _VEHICLE_H
 #define _VEHICLE_H
 
+#include <memory>
+#include <string>
+
 #include "./IChargeable.h"
 
 using std::shared_ptr;
@@ -11,7 +14,18 @@ enum OperationState {
     waiting_for_charge_queue,
     in_charge_queue,
     charging,
+    grounded,   // Out of service for maintenance after a fault (fleet engine with faults on)
+    parked,     // Idle until a trip request wakes it (fleet engine with a demand profile, see Demand.h)
 };
+const unsigned int cNumberOfOperationStates = OperationState::parked + 1;
+
+// Name of an OperationState as shown in telemetry, profiles and the live monitor
+const char* operationStateName(unsigned int state);
+
+// An operation counts as complete once its time is within this many simulated minutes of its length. The
+// operation time is a running sum of increments, so without it rounding decides whether an operation
+// that should end on a step ends there or one step later.
+const double cOperationTimeTolerance = 1e-9;
 
 // These structures store Vehicle Model date. Vehicles of the same model
 // share a single Model Record.
@@ -35,8 +49,16 @@ struct ModelData {
     double totalFlightTime;
     double totalChargingTime;
     double totalWaitingTime;
+    double totalGroundedTime;
+    unsigned long totalFaults;  // Faults that happened, only when faults are simulated
 
     void prinResult();
+
+    // Zero the fleet count and totals so the record can be reused for another run
+    void reset();
+
+    // Zero the totals only, for a run that carries on with the same fleet
+    void resetTotals();
 };
 
 // Class to track & iterate vehicle state
@@ -72,8 +94,21 @@ public:
 
     ~Vehicle();
 
-    // Iterate by delta-time, units are simulated minutes
-    void iterate(double deltaT);
+    // Iterate by delta-time, units are simulated minutes. Returns timeRemaining() after the step.
+    double iterate(double deltaT);
+
+    // Event driven stepping (see EventSimulation.h)
+    // Simulated minutes left in the current operation. Infinity for the queue states as
+    // those are ended by the ChargingStation rather than the vehicle.
+    double timeRemaining() const;
+
+    // Advance by delta-time and count all of it towards the current operation. Unlike iterate()
+    // the caller never steps past timeRemaining(), so there is no overrun to carry over.
+    void advance(double deltaT);
+
+    // Count time spent in the charge queue after the fact - the event engine only knows how long
+    // a vehicle waited once the ChargingStation has already moved it to "charging".
+    void addWaitTime(double deltaT);
 
     // Print out various results;
     void printResult() const;
@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include <FleetSimulation.h>
+#include <Simulation.h>
+#include <StaticFleet.h>
+
+// One pass of the tick engine over a fleet of the default models
+static void BM_TickEngineStep(benchmark::State& state) {
+    const unsigned int fleetSize = static_cast<unsigned int>(state.range(0));
+    Scenario scenario = defaultScenario();
+    VehicleModelMap modelStates;
+    initializeModels(scenario, modelStates);
+    RandomStream rng(1);
+    vector<shared_ptr<Vehicle>> vehicles = generateFleet(modelStates, scenario.modelWeights, fleetSize, 1);
+    ChargingStation chargingStation(scenario.numberOfChargingSlots);
+    vector<shared_ptr<Vehicle>> landed;
+    landed.reserve(fleetSize);
+
+    for (auto _ : state) {
+        stepTick(vehicles, chargingStation, scenario.increment, rng, landed);
+    }
+    state.SetItemsProcessed(state.iterations() * fleetSize);
+}
+BENCHMARK(BM_TickEngineStep)->Arg(20)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+// One pass of the fleet engine over a fleet of the default models
+static void BM_FleetEngineStep(benchmark::State& state) {
+    const unsigned int fleetSize = static_cast<unsigned int>(state.range(0));
+    Scenario scenario = defaultScenario();
+    VehicleModelMap modelStates;
+    initializeModels(scenario, modelStates);
+    FleetState fleet(modelList(modelStates));
+    generateFleet(scenario.modelWeights, fleetSize, 1, fleet);
+    StationNetwork stations(1, scenario.numberOfChargingSlots, fleetSize,
+                            makeRoutingPolicy(scenario.routing, 1));
+    ThreadPool pool(1);
+    vector<VehicleIndex> landed;
+    vector<VehicleIndex> charged;
+    landed.reserve(fleetSize);
+    charged.reserve(fleetSize);
+
+    for (auto _ : state) {
+        stepFleet(fleet, stations, scenario.increment, pool, landed, charged);
+    }
+    state.SetItemsProcessed(state.iterations() * fleetSize);
+}
+BENCHMARK(BM_FleetEngineStep)->Arg(20)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+// One pass of the static engine over the same fleet as BM_FleetEngineStep, to compare the build time
+// specialized models with the runtime parameter table
+static void BM_StaticEngineStep(benchmark::State& state) {
+    const unsigned int fleetSize = static_cast<unsigned int>(state.range(0));
+    Scenario scenario = defaultScenario();
+    DefaultStaticFleet fleet(static_cast<unsigned int>(scenario.numberOfChargingSlots));
+    for (ModelIndex model : drawFleetModels(scenario.modelWeights, fleetSize, 1)) {
+        fleet.addVehicle(model);
+    }
+
+    for (auto _ : state) {
+        fleet.step(scenario.increment);
+    }
+    state.SetItemsProcessed(state.iterations() * fleetSize);
+}
+BENCHMARK(BM_StaticEngineStep)->Arg(20)->Arg(1000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+// Building the model records of the default scenario
+static void BM_InitializeModels(benchmark::State& state) {
+    Scenario scenario = defaultScenario();
+    for (auto _ : state) {
+        VehicleModelMap modelStates;
+        initializeModels(scenario, modelStates);
+        benchmark::DoNotOptimize(modelStates);
+    }
+}
+BENCHMARK(BM_InitializeModels);
+
+// Building a fleet of Vehicle objects for the tick and event engines
+static void BM_GenerateVehicles(benchmark::State& state) {
+    const unsigned int fleetSize = static_cast<unsigned int>(state.range(0));
+    Scenario scenario = defaultScenario();
+    VehicleModelMap modelStates;
+    initializeModels(scenario, modelStates);
+
+    for (auto _ : state) {
+        vector<shared_ptr<Vehicle>> vehicles = generateFleet(modelStates, scenario.modelWeights, fleetSize, 1);
+        benchmark::DoNotOptimize(vehicles.data());
+    }
+    state.SetItemsProcessed(state.iterations() * fleetSize);
+}
+BENCHMARK(BM_GenerateVehicles)->Arg(20)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+// Building a FleetState for the fleet engine
+static void BM_GenerateFleetState(benchmark::State& state) {
+    const unsigned int fleetSize = static_cast<unsigned int>(state.range(0));
+    Scenario scenario = defaultScenario();
+    VehicleModelMap modelStates;
+    initializeModels(scenario, modelStates);
+
+    for (auto _ : state) {
+        FleetState fleet(modelList(modelStates));
+        generateFleet(scenario.modelWeights, fleetSize, 1, fleet);
+        benchmark::DoNotOptimize(fleet.size());
+    }
+    state.SetItemsProcessed(state.iterations() * fleetSize);
+}
+BENCHMARK(BM_GenerateFleetState)->Arg(20)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+// One telemetry sample of a fleet engine run, written to a scratch file
+static void BM_TelemetryRecord(benchmark::State& state) {
+    const unsigned int fleetSize = static_cast<unsigned int>(state.range(0));
+    Scenario scenario = defaultScenario();
+    VehicleModelMap modelStates;
+    initializeModels(scenario, modelStates);
+    FleetState fleet(modelList(modelStates));
+    generateFleet(scenario.modelWeights, fleetSize, 1, fleet);
+    StationNetwork stations(1, scenario.numberOfChargingSlots, fleetSize, makeRoutingPolicy(scenario.routing, 1));
+    const std::string path = std::string(P_tmpdir) + "/joby_benchmark_telemetry.bin";
+    {
+        Telemetry telemetry(path, 1.0, modelList(modelStates));
+        double time = 0.0;
+        for (auto _ : state) {
+            telemetry.record(time, fleet, stations);
+            time += 1.0;
+        }
+    }
+    // The writer is done with the file once the telemetry is gone
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_TelemetryRecord)->Arg(100000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,142 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include <ChargingStation.h>
+#include <FleetChargingStation.h>
+#include <Geography.h>
+#include <Vehicle.h>
+
+namespace {
+
+// Flights and charges of 1 minute stepped 0.25 minutes at a time, with three times as many vehicles as
+// slots - every iterate has vehicles finishing their charge and a queue waiting for the slots
+const double cEndurance = 1.0;
+const double cIncrement = 0.25;
+
+shared_ptr<ModelData> makeModel() {
+    return shared_ptr<ModelData>(new ModelData({{"Bench", 100.0, 100.0, cEndurance, 1.0, 1, 0.0, cEndurance}, 0, 0, 0, 0}));
+}
+
+}
+
+// Cost of one FleetChargingStation::iterate, the fleet stepping in between isn't timed
+static void BM_FleetChargingStationIterate(benchmark::State& state) {
+    const unsigned int slots = static_cast<unsigned int>(state.range(0));
+    const unsigned int fleetSize = 3 * slots;
+
+    FleetState fleet({makeModel()});
+    for (unsigned int i = 0; i < fleetSize; ++i) {
+        fleet.addVehicle(0);
+    }
+    FleetChargingStation station(slots);
+    vector<VehicleIndex> landed;
+    landed.reserve(fleetSize);
+
+    for (auto _ : state) {
+        landed.clear();
+        fleet.iterate(cIncrement, landed);
+        for (VehicleIndex v : landed) {
+            station.addVehicle(fleet, v);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        station.iterate(fleet);
+        auto end = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+    }
+    state.counters["charging"] = station.getNumberCharging();
+    state.counters["waiting"] = static_cast<double>(station.getNumberWaiting());
+}
+BENCHMARK(BM_FleetChargingStationIterate)->Arg(3)->Arg(100)->Arg(10000)->UseManualTime();
+
+// Cost of one ChargingStation::iterate for comparison, the vehicle iterates in between aren't timed
+static void BM_ChargingStationIterate(benchmark::State& state) {
+    const unsigned int slots = static_cast<unsigned int>(state.range(0));
+    const unsigned int fleetSize = 3 * slots;
+
+    auto model = makeModel();
+    vector<shared_ptr<Vehicle>> vehicles;
+    for (unsigned int i = 0; i < fleetSize; ++i) {
+        vehicles.push_back(shared_ptr<Vehicle>(new Vehicle(model)));
+    }
+    ChargingStation station(static_cast<int>(slots));
+
+    for (auto _ : state) {
+        for (auto& vehicle : vehicles) {
+            vehicle->iterate(cIncrement);
+            if (vehicle->isWaitingForQueue()) {
+                station.addVehicle(vehicle);
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        station.iterate();
+        auto end = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+    }
+}
+BENCHMARK(BM_ChargingStationIterate)->Arg(3)->Arg(100)->Arg(10000)->UseManualTime();
+
+// Cost of ChargingStation::addVehicle onto a queue already depth vehicles deep
+static void BM_ChargingStationAddVehicle(benchmark::State& state) {
+    const size_t depth = static_cast<size_t>(state.range(0));
+
+    auto model = makeModel();
+    vector<shared_ptr<Vehicle>> vehicles;
+    for (size_t i = 0; i < depth + 1; ++i) {
+        vehicles.push_back(shared_ptr<Vehicle>(new Vehicle(model)));
+    }
+
+    // Kept outside the loop so the old station is freed while the timer is paused
+    std::unique_ptr<ChargingStation> station;
+    for (auto _ : state) {
+        state.PauseTiming();
+        station.reset(new ChargingStation(1));
+        for (size_t i = 0; i < depth; ++i) {
+            station->addVehicle(vehicles[i]);
+        }
+        state.ResumeTiming();
+
+        station->addVehicle(vehicles[depth]);
+    }
+}
+BENCHMARK(BM_ChargingStationAddVehicle)->Arg(0)->Arg(100)->Arg(10000);
+
+// Cost of a ChargingStation::iterate with full slots and a queue depth vehicles deep
+static void BM_ChargingStationIterateQueued(benchmark::State& state) {
+    const size_t depth = static_cast<size_t>(state.range(0));
+    const int slots = 3;
+
+    auto model = makeModel();
+    vector<shared_ptr<Vehicle>> vehicles;
+    ChargingStation station(slots);
+    for (size_t i = 0; i < slots + depth; ++i) {
+        vehicles.push_back(shared_ptr<Vehicle>(new Vehicle(model)));
+        station.addVehicle(vehicles.back());
+    }
+    station.iterate();
+
+    for (auto _ : state) {
+        station.iterate();
+    }
+}
+BENCHMARK(BM_ChargingStationIterateQueued)->Arg(0)->Arg(100)->Arg(10000);
+
+// Cost of finding the nearest of n stations spread over 50 miles to a landing vertiport, the queries
+// cycle through 1000 of 10k vertiports on the same map
+static void BM_NearestStation(benchmark::State& state) {
+    const size_t stations = static_cast<size_t>(state.range(0));
+    const size_t vertiports = std::max<size_t>(stations, 10000);
+    VertiportMap map(vertiports, 50.0, 1);
+    NearestIndex index(vector<Position>(map.getPositions().begin(), map.getPositions().begin() + stations));
+
+    VertiportIndex vertiport = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.nearest(map.position(vertiport)));
+        vertiport = (vertiport + 7919) % 1000 * (vertiports / 1000);
+    }
+}
+BENCHMARK(BM_NearestStation)->Arg(10)->Arg(1000)->Arg(10000)->Arg(100000);
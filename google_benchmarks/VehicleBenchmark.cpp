@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include <Vehicle.h>
+
+namespace {
+
+// Long flights and charges so a benchmark run never finishes an operation
+shared_ptr<ModelData> makeModel() {
+    return shared_ptr<ModelData>(new ModelData({{"Bench", 100.0, 100.0, 1e9, 1.0, 1, 0.0, 1e9}, 0, 0, 0, 0}));
+}
+
+// Put a new vehicle into the given state
+void moveToState(Vehicle& vehicle, OperationState state) {
+    if (state == OperationState::en_route) {
+        return;
+    }
+    vehicle.iterate(1e9);
+    if (state == OperationState::waiting_for_charge_queue) {
+        return;
+    }
+    vehicle.setInWaitQueue();
+    if (state == OperationState::charging) {
+        vehicle.setCharging();
+    }
+}
+
+}
+
+// Cost of Vehicle::iterate in each operation state
+static void BM_VehicleIterate(benchmark::State& state) {
+    OperationState opState = static_cast<OperationState>(state.range(0));
+    Vehicle vehicle(makeModel());
+    moveToState(vehicle, opState);
+
+    for (auto _ : state) {
+        vehicle.iterate(1e-6);
+        benchmark::DoNotOptimize(vehicle);
+    }
+    state.SetLabel(opState == OperationState::en_route ? "en_route" :
+                   opState == OperationState::charging ? "charging" :
+                   opState == OperationState::in_charge_queue ? "in_charge_queue" : "waiting_for_charge_queue");
+}
+BENCHMARK(BM_VehicleIterate)
+        ->Arg(OperationState::en_route)
+        ->Arg(OperationState::waiting_for_charge_queue)
+        ->Arg(OperationState::in_charge_queue)
+        ->Arg(OperationState::charging);
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include <Checkpoint.h>
+#include <FleetSimulation.h>
+
+namespace {
+
+const unsigned int cFleetSize = 500;
+
+vector<shared_ptr<ModelData>> makeModels() {
+    return {shared_ptr<ModelData>(new ModelData({{"Alpha", 100.0, 100.0, 10.0, 1.5, 5, 2.0, 40.0}, 0, 0, 0, 0})),
+            shared_ptr<ModelData>(new ModelData({{"Beta", 100.0, 100.0, 25.0, 1.5, 5, 0.5, 55.0}, 0, 0, 0, 0}))};
+}
+
+// A congested run with faults, and trips and partial charges, so every part of the state is in play
+void buildFleet(FleetState& fleet, bool battery = false) {
+    fleet.enableFaults(7, 15.0);
+    if (battery) {
+        fleet.enableBattery(7, 5.0, 30.0, 0.7);
+    }
+    for (unsigned int i = 0; i < cFleetSize; ++i) {
+        fleet.addVehicle(static_cast<ModelIndex>(i % 3 == 0));
+    }
+}
+
+}
+
+// Test restoring a checkpoint and carrying on is bit identical to a run that never stopped
+TEST(CheckpointTest, restoreContinues) {
+    const std::string path = testing::TempDir() + "checkpoint_test.ckp";
+    // Round robin routing with the battery model and stations serving by charge need
+    for (StationRouting routing : {StationRouting::least_queued_routing, StationRouting::round_robin_routing}) {
+        bool battery = routing == StationRouting::round_robin_routing;
+        auto models = makeModels();
+        FleetState fleet(models);
+        buildFleet(fleet, battery);
+        SessionStatistics sessions(models.size());
+        fleet.recordSessions(&sessions);
+        StationNetwork stations(3, 4, cFleetSize, makeRoutingPolicy(routing, 3), battery);
+        ThreadPool pool(1);
+        FleetCheckpoint save{FleetClock{0.0, 0}, path, 73.3};
+        unsigned long iterations = runFleetLoop(fleet, stations, nullptr, 0.1, 200.0, pool, nullptr, &save);
+
+        auto restoredModels = makeModels();
+        FleetState restoredFleet(restoredModels);
+        SessionStatistics restoredSessions(models.size());
+        restoredFleet.recordSessions(&restoredSessions);
+        StationNetwork restoredStations(3, 4, cFleetSize, makeRoutingPolicy(routing, 3), battery);
+        FleetCheckpoint restore{FleetClock{0.0, 0}, "", 0.0};
+        std::string error;
+        ASSERT_TRUE(loadCheckpoint(path, restore.start, restoredFleet, restoredStations, error)) << error;
+        EXPECT_GE(restore.start.currentTime, 73.3);
+        EXPECT_LT(restore.start.currentTime, 73.5);
+        EXPECT_EQ(restoredModels[0]->fleetCount, models[0]->fleetCount);
+        EXPECT_EQ(restoredModels[1]->fleetCount, models[1]->fleetCount);
+
+        ThreadPool restoredPool(2);
+        EXPECT_EQ(runFleetLoop(restoredFleet, restoredStations, nullptr, 0.1, 200.0, restoredPool, nullptr, &restore),
+                  iterations);
+
+        for (size_t m = 0; m < models.size(); ++m) {
+            EXPECT_EQ(restoredModels[m]->totalFlightTime, models[m]->totalFlightTime);
+            EXPECT_EQ(restoredModels[m]->totalChargingTime, models[m]->totalChargingTime);
+            EXPECT_EQ(restoredModels[m]->totalWaitingTime, models[m]->totalWaitingTime);
+            EXPECT_EQ(restoredModels[m]->totalGroundedTime, models[m]->totalGroundedTime);
+            EXPECT_EQ(restoredModels[m]->totalFaults, models[m]->totalFaults);
+            EXPECT_EQ(restoredSessions.getWaits(m).getCount(), sessions.getWaits(m).getCount());
+            EXPECT_EQ(restoredSessions.getWaits(m).getTotal(), sessions.getWaits(m).getTotal());
+            EXPECT_EQ(restoredSessions.getWaits(m).percentile(0.9), sessions.getWaits(m).percentile(0.9));
+            EXPECT_EQ(restoredSessions.getCharges(m).getCount(), sessions.getCharges(m).getCount());
+            EXPECT_EQ(restoredSessions.getCharges(m).getMaximum(), sessions.getCharges(m).getMaximum());
+        }
+        EXPECT_GT(sessions.getWaits(0).getCount(), 0u);
+        EXPECT_GT(models[0]->totalWaitingTime, 0.0);
+        EXPECT_GT(models[0]->totalFaults, 0u);
+        for (VehicleIndex v = 0; v < cFleetSize; ++v) {
+            EXPECT_EQ(restoredFleet.getOpState(v), fleet.getOpState(v));
+            EXPECT_EQ(restoredFleet.getTotalTimeEnRoute(v), fleet.getTotalTimeEnRoute(v));
+            EXPECT_EQ(restoredFleet.getTotalTimeWaiting(v), fleet.getTotalTimeWaiting(v));
+            EXPECT_EQ(restoredStations.getVehicleStation(v), stations.getVehicleStation(v));
+            if (battery) {
+                EXPECT_EQ(restoredFleet.getStateOfCharge(v), fleet.getStateOfCharge(v));
+            }
+        }
+    }
+}
+
+// Test checkpoints that don't fit are turned down
+TEST(CheckpointTest, rejects) {
+    const std::string path = testing::TempDir() + "checkpoint_reject_test.ckp";
+    auto models = makeModels();
+    FleetState fleet(models);
+    buildFleet(fleet);
+    StationNetwork stations(3, 4, cFleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 3));
+    std::string error;
+    ASSERT_TRUE(saveCheckpoint(path, FleetClock{12.5, 125}, fleet, stations, error)) << error;
+
+    // A different number of stations
+    {
+        FleetState restoredFleet(makeModels());
+        StationNetwork restoredStations(2, 4, cFleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 2));
+        FleetClock clock;
+        EXPECT_FALSE(loadCheckpoint(path, clock, restoredFleet, restoredStations, error));
+        EXPECT_EQ(error, path + ": checkpoint has 3 stations, the scenario has 2");
+    }
+
+    // Different models
+    {
+        FleetState restoredFleet({makeModels()[1], makeModels()[0]});
+        StationNetwork restoredStations(3, 4, cFleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 3));
+        FleetClock clock;
+        EXPECT_FALSE(loadCheckpoint(path, clock, restoredFleet, restoredStations, error));
+        EXPECT_EQ(error, path + ": checkpoint model Alpha doesn't match the scenario");
+        EXPECT_EQ(restoredFleet.size(), 0u);
+    }
+
+    // Sessions recorded by the run but not by the checkpoint
+    {
+        FleetState restoredFleet(makeModels());
+        SessionStatistics sessions(2);
+        restoredFleet.recordSessions(&sessions);
+        StationNetwork restoredStations(3, 4, cFleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 3));
+        FleetClock clock;
+        EXPECT_FALSE(loadCheckpoint(path, clock, restoredFleet, restoredStations, error));
+        EXPECT_EQ(error, path + ": checkpoint has no charging sessions");
+        EXPECT_EQ(restoredFleet.size(), 0u);
+    }
+
+    // Cut short
+    std::ifstream in(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(contents.data(), contents.size() / 2);
+    {
+        FleetState restoredFleet(makeModels());
+        StationNetwork restoredStations(3, 4, cFleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 3));
+        FleetClock clock;
+        EXPECT_FALSE(loadCheckpoint(path, clock, restoredFleet, restoredStations, error));
+        EXPECT_EQ(error, path + ": truncated checkpoint");
+    }
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a checkpoint";
+    {
+        FleetState restoredFleet(makeModels());
+        StationNetwork restoredStations(3, 4, cFleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 3));
+        FleetClock clock;
+        EXPECT_FALSE(loadCheckpoint(path, clock, restoredFleet, restoredStations, error));
+        EXPECT_EQ(error, path + ": not a checkpoint file");
+    }
+}
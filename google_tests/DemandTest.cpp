@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <fstream>
+
+#include <Demand.h>
+#include <FleetSimulation.h>
+
+#include "TestModels.h"
+
+namespace {
+
+bool loadProfile(const std::string& contents, DemandProfile& profile, std::string& error) {
+    const std::string path = testing::TempDir() + "demand_test.txt";
+    std::ofstream(path) << contents;
+    return profile.load(path, error);
+}
+
+}
+
+// Test the rates and the inverse of the expected requests, across the changes of rate and midnight
+TEST(DemandTest, profile) {
+    DemandProfile profile;
+    EXPECT_EQ(profile.rate(10.0), 0.0);
+    EXPECT_TRUE(std::isinf(profile.timeAfter(0.0, 1.0)));
+
+    // 1 a minute to 06:00, none to 18:00, 2 a minute to midnight
+    profile.addRate(0.0, 60.0);
+    profile.addRate(360.0, 0.0);
+    profile.addRate(1080.0, 120.0);
+    EXPECT_DOUBLE_EQ(profile.getRequestsPerDay(), 1080.0);
+    EXPECT_DOUBLE_EQ(profile.rate(10.0), 1.0);
+    EXPECT_DOUBLE_EQ(profile.rate(400.0), 0.0);
+    EXPECT_DOUBLE_EQ(profile.rate(1100.0), 2.0);
+    EXPECT_DOUBLE_EQ(profile.rate(1450.0), 1.0);
+
+    EXPECT_DOUBLE_EQ(profile.timeAfter(0.0, 30.0), 30.0);
+    // 10 before 06:00, then 10 more after 18:00
+    EXPECT_DOUBLE_EQ(profile.timeAfter(350.0, 20.0), 1085.0);
+    // Whole days are skipped
+    EXPECT_DOUBLE_EQ(profile.timeAfter(0.0, 2 * 1080.0 + 30.0), 2 * 1440.0 + 30.0);
+    EXPECT_DOUBLE_EQ(profile.timeAfter(1430.0, 30.0), 1450.0);
+
+    // The last rate of the day carries on through midnight
+    DemandProfile evening;
+    evening.addRate(360.0, 60.0);
+    EXPECT_DOUBLE_EQ(evening.rate(10.0), 1.0);
+    EXPECT_DOUBLE_EQ(evening.timeAfter(1430.0, 20.0), 1450.0);
+}
+
+// Test loading a profile and the errors for bad files
+TEST(DemandTest, load) {
+    DemandProfile profile;
+    std::string error;
+    ASSERT_TRUE(loadProfile("# Weekday\n00:00 60 ; night\n\n06:30  0\n18:00 120\n", profile, error)) << error;
+    EXPECT_DOUBLE_EQ(profile.rate(389.0), 1.0);
+    EXPECT_DOUBLE_EQ(profile.rate(390.0), 0.0);
+    EXPECT_DOUBLE_EQ(profile.rate(1439.0), 2.0);
+
+    EXPECT_FALSE(loadProfile("", profile, error));
+    EXPECT_NE(error.find(": no rates"), std::string::npos);
+    EXPECT_FALSE(loadProfile("06:00 10\n05:00 10\n", profile, error));
+    EXPECT_NE(error.find(":2: times must be in order"), std::string::npos);
+    EXPECT_FALSE(loadProfile("24:00 10\n", profile, error));
+    EXPECT_NE(error.find(":1: expected hh:mm requests-per-hour"), std::string::npos);
+    EXPECT_FALSE(loadProfile("06:00\n", profile, error));
+    EXPECT_NE(error.find(":1: expected"), std::string::npos);
+    EXPECT_FALSE(loadProfile("06:00 -1\n", profile, error));
+    EXPECT_NE(error.find(":1: bad requests per hour -1"), std::string::npos);
+    EXPECT_FALSE(profile.load(testing::TempDir() + "no_such_demand.txt", error));
+
+    // A failed load leaves the profile alone
+    EXPECT_DOUBLE_EQ(profile.rate(1439.0), 2.0);
+}
+
+// Test vehicles start parked, wake lowest index first and park again after charging
+TEST(DemandTest, parkAndWake) {
+    auto testModel = makeModel();
+    FleetState fleet({testModel});
+    fleet.enableDemand();
+    const size_t fleetSize = 2 * FleetState::cBlockSize + 5;
+    for (size_t i = 0; i < fleetSize; ++i) {
+        fleet.addVehicle(0);
+    }
+    EXPECT_EQ(fleet.numberParked(), fleetSize);
+    EXPECT_EQ(fleet.getOpState(static_cast<VehicleIndex>(fleetSize - 1)), OperationState::parked);
+
+    vector<VehicleIndex> landed;
+    vector<VehicleIndex> charged;
+    fleet.iterate(100.0, landed, charged);
+    EXPECT_TRUE(landed.empty());
+
+    EXPECT_EQ(fleet.wake(), 0u);
+    EXPECT_EQ(fleet.wake(), 1u);
+    EXPECT_EQ(fleet.numberParked(), fleetSize - 2);
+    EXPECT_EQ(fleet.getOpState(0), OperationState::en_route);
+
+    // Without the battery model a trip is a flight until the battery is flat
+    fleet.iterate(76.0, landed, charged);
+    fleet.iterate(1.0, landed, charged);
+    ASSERT_EQ(landed.size(), 2u);
+    fleet.setCharging(0);
+    fleet.setCharging(1);
+    landed.clear();
+    fleet.iterate(43.0, landed, charged);
+    fleet.iterate(1.0, landed, charged);
+    ASSERT_EQ(charged.size(), 2u);
+    EXPECT_EQ(charged[0], 0u);
+    EXPECT_EQ(fleet.getOpState(0), OperationState::parked);
+    EXPECT_EQ(fleet.numberParked(), fleetSize);
+    EXPECT_EQ(fleet.wake(), 0u);
+
+    // Same as iterate() the step that completes an operation isn't counted, parked time isn't counted at all
+    fleet.iterate(10.0, landed, charged);
+    EXPECT_DOUBLE_EQ(fleet.getTotalTimeEnRoute(1), 76.0);
+    EXPECT_DOUBLE_EQ(fleet.getTotalTimeCharging(1), 43.0);
+}
+
+// Test a fleet engine run serves the requests, keeps the vehicles in use in the low blocks and is
+// repeatable from its seed
+TEST(DemandTest, fleetLoop) {
+    DemandProfile profile;
+    profile.addRate(0.0, 60.0);
+    const size_t fleetSize = 4 * FleetState::cBlockSize;
+
+    uint64_t served[2];
+    for (int run = 0; run < 2; ++run) {
+        auto testModel = makeModel();
+        FleetState fleet({testModel});
+        fleet.enableDemand();
+        for (size_t i = 0; i < fleetSize; ++i) {
+            fleet.addVehicle(0);
+        }
+        StationNetwork stations(1, 100, fleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 1), false);
+        ThreadPool pool(2);
+        FleetDemand demand(profile, 7);
+        runFleetLoop(fleet, stations, nullptr, 0.5, 180.0, pool, nullptr, nullptr, &demand);
+
+        // About a request a minute, each taking a vehicle for 77 minutes of flight and 44 of charging,
+        // so there is always a vehicle parked and the last block is never used
+        EXPECT_NEAR(static_cast<double>(demand.getRequests()), 180.0, 50.0);
+        EXPECT_EQ(demand.getRequests(), demand.getServed() + demand.getWaiting());
+        EXPECT_EQ(demand.getWaiting(), 0u);
+        EXPECT_LT(demand.getAverageWait(), 0.5);
+        EXPECT_EQ(fleet.getOpState(static_cast<VehicleIndex>(fleetSize - 1)), OperationState::parked);
+        EXPECT_GT(testModel->totalFlightTime, 0.0);
+        served[run] = demand.getServed();
+    }
+    EXPECT_EQ(served[0], served[1]);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <Simulation.h>
+#include <EventSimulation.h>
+
+#include "TestModels.h"
+
+namespace {
+
+// A fleet of a single model so the order vehicles reach the charging station doesn't matter
+vector<shared_ptr<Vehicle>> makeFleet(shared_ptr<ModelData> model, unsigned int fleetSize) {
+    vector<shared_ptr<Vehicle>> vehicles;
+    for (unsigned int i = 0; i < fleetSize; ++i) {
+        vehicles.push_back(shared_ptr<Vehicle>(new Vehicle(model)));
+        ++(model->fleetCount);
+    }
+    return vehicles;
+}
+
+}
+
+// With enough chargers nobody waits and totals are exact
+TEST(EventSimulationTest, uncontended) {
+    auto model = makeFlightModel(12.0);
+    auto vehicles = makeFleet(model, 2);
+    ChargingStation chargingStation(2);
+
+    // Two full cycles of 40 minutes flight + 12 minutes charging, then 4 minutes of flight
+    runEventLoop(vehicles, chargingStation, 108.0);
+
+    EXPECT_DOUBLE_EQ(model->totalFlightTime, 2 * (40.0 + 40.0 + 4.0));
+    EXPECT_DOUBLE_EQ(model->totalChargingTime, 2 * (12.0 + 12.0));
+    EXPECT_DOUBLE_EQ(model->totalWaitingTime, 0.0);
+}
+
+// One charger for two vehicles - the second vehicle waits for the first to finish
+TEST(EventSimulationTest, waitForSlot) {
+    auto model = makeFlightModel(12.0);
+    auto vehicles = makeFleet(model, 2);
+    ChargingStation chargingStation(1);
+
+    runEventLoop(vehicles, chargingStation, 60.0);
+
+    EXPECT_DOUBLE_EQ(model->totalFlightTime, 2 * 40.0 + 8.0);
+    EXPECT_DOUBLE_EQ(model->totalChargingTime, 12.0 + 8.0);
+    EXPECT_DOUBLE_EQ(model->totalWaitingTime, 12.0);
+}
+
+// The event engine matches the tick engine to within about one increment per state change
+TEST(EventSimulationTest, matchesTickLoop) {
+    const double runTime = 600.0;
+    const double increment = 0.01;
+    const unsigned int fleetSize = 8;
+
+    auto tickModel = makeFlightModel(12.0);
+    auto tickVehicles = makeFleet(tickModel, fleetSize);
+    ChargingStation tickStation(3);
+    RandomStream rng(1);
+    runTickLoop(tickVehicles, tickStation, nullptr, increment, runTime, rng);
+
+    auto eventModel = makeFlightModel(12.0);
+    auto eventVehicles = makeFleet(eventModel, fleetSize);
+    ChargingStation eventStation(3);
+    runEventLoop(eventVehicles, eventStation, runTime);
+
+    // Three state changes per flight/charge cycle
+    double stateChanges = 3.0 * runTime / (eventModel->params.endurance + eventModel->params.timeToCharge);
+    double tolerance = fleetSize * (stateChanges + 1.0) * increment;
+    EXPECT_NEAR(tickModel->totalFlightTime, eventModel->totalFlightTime, tolerance);
+    EXPECT_NEAR(tickModel->totalChargingTime, eventModel->totalChargingTime, tolerance);
+    EXPECT_NEAR(tickModel->totalWaitingTime, eventModel->totalWaitingTime, tolerance);
+}
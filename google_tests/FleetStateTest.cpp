@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include <FleetState.h>
+#include <FleetSimulation.h>
+#include <Simulation.h>
+
+#include "TestModels.h"
+
+// Test the iterate method - same steps as VehicleTest.iterate
+TEST(FleetStateTest, iterate) {
+    auto testModel = makeModel();
+    FleetState fleet({testModel});
+    VehicleIndex v = fleet.addVehicle(0);
+    EXPECT_EQ(testModel->fleetCount, 1u);
+    EXPECT_EQ(fleet.getOpState(v), OperationState::en_route);
+
+    vector<VehicleIndex> landed;
+    fleet.iterate(1.0, landed);
+    EXPECT_EQ(fleet.getOpState(v), OperationState::en_route);
+
+    fleet.iterate(75.9, landed);
+    EXPECT_EQ(fleet.getOpState(v), OperationState::en_route);
+    EXPECT_TRUE(landed.empty());
+
+    fleet.iterate(0.1, landed);
+    EXPECT_EQ(fleet.getOpState(v), OperationState::waiting_for_charge_queue);
+    ASSERT_EQ(landed.size(), 1u);
+    EXPECT_EQ(landed[0], v);
+
+    fleet.setCharging(v);
+    EXPECT_EQ(fleet.getOpState(v), OperationState::charging);
+
+    fleet.iterate(43.9, landed);
+    EXPECT_EQ(fleet.getOpState(v), OperationState::charging);
+
+    fleet.iterate(0.1, landed);
+    EXPECT_EQ(fleet.getOpState(v), OperationState::en_route);
+
+    EXPECT_DOUBLE_EQ(fleet.getTotalTimeEnRoute(v), 76.9);
+    EXPECT_DOUBLE_EQ(fleet.getTotalTimeCharging(v), 43.9);
+}
+
+// Only vehicles across block boundaries that change state are reported
+TEST(FleetStateTest, landedAcrossBlocks) {
+    auto testModel = makeModel();
+    FleetState fleet({testModel});
+    const size_t fleetSize = 3 * FleetState::cBlockSize + 7;
+    for (size_t i = 0; i < fleetSize; ++i) {
+        fleet.addVehicle(0);
+    }
+
+    vector<VehicleIndex> landed;
+    fleet.iterate(77.0, landed);
+    ASSERT_EQ(landed.size(), fleetSize);
+    for (size_t i = 0; i < fleetSize; ++i) {
+        EXPECT_EQ(landed[i], i);
+        EXPECT_TRUE(fleet.isWaitingForQueue(landed[i]));
+    }
+}
+
+// The fleet loop gives the same model totals as the Vehicle based tick loop
+TEST(FleetStateTest, matchesTickLoop) {
+    const double runTime = 600.0;
+    const double increment = 0.01;
+    const unsigned int fleetSize = 8;
+
+    auto tickModel = makeFlightModel(12.0);
+    vector<shared_ptr<Vehicle>> vehicles;
+    for (unsigned int i = 0; i < fleetSize; ++i) {
+        vehicles.push_back(shared_ptr<Vehicle>(new Vehicle(tickModel)));
+    }
+    ChargingStation tickStation(3);
+    RandomStream rng(1);
+    runTickLoop(vehicles, tickStation, nullptr, increment, runTime, rng);
+
+    auto fleetModel = makeFlightModel(12.0);
+    FleetState fleet({fleetModel});
+    for (unsigned int i = 0; i < fleetSize; ++i) {
+        fleet.addVehicle(0);
+    }
+    StationNetwork fleetStations(1, 3, fleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 1));
+    ThreadPool pool(1);
+    runFleetLoop(fleet, fleetStations, nullptr, increment, runTime, pool);
+
+    EXPECT_NEAR(tickModel->totalFlightTime, fleetModel->totalFlightTime, 1e-6);
+    EXPECT_NEAR(tickModel->totalChargingTime, fleetModel->totalChargingTime, 1e-6);
+    EXPECT_NEAR(tickModel->totalWaitingTime, fleetModel->totalWaitingTime, 1e-6);
+}
+
+// Stepping across a pool gives bit identical results for any number of threads
+TEST(FleetStateTest, threadCountIndependent) {
+    const unsigned int fleetSize = 3 * FleetState::cChunkSize + 100;
+    vector<shared_ptr<ModelData>> referenceModels;
+
+    for (unsigned int threads : {1u, 2u, 3u, 8u}) {
+        Scenario scenario = defaultScenario();
+        VehicleModelMap modelStates;
+        initializeModels(scenario, modelStates);
+        vector<shared_ptr<ModelData>> models = modelList(modelStates);
+        FleetState fleet(models);
+        generateFleet(scenario.modelWeights, fleetSize, 42, fleet);
+
+        StationNetwork stations(1, 100, fleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 1));
+        ThreadPool pool(threads);
+        runFleetLoop(fleet, stations, nullptr, 0.05, 120.0, pool);
+
+        if (referenceModels.empty()) {
+            referenceModels = models;
+            continue;
+        }
+        for (size_t m = 0; m < models.size(); ++m) {
+            EXPECT_EQ(models[m]->totalFlightTime, referenceModels[m]->totalFlightTime);
+            EXPECT_EQ(models[m]->totalChargingTime, referenceModels[m]->totalChargingTime);
+            EXPECT_EQ(models[m]->totalWaitingTime, referenceModels[m]->totalWaitingTime);
+        }
+    }
+}
+
+// Faults ground vehicles for maintenance at about the model's rate, the same way for any number of threads
+TEST(FleetStateTest, faults) {
+    const unsigned int fleetSize = 2 * FleetState::cChunkSize;
+    // 6 faults per flight hour, so about one every 10 minutes of a 40 minute flight
+    vector<shared_ptr<ModelData>> referenceModels;
+    for (unsigned int threads : {1u, 3u}) {
+        auto model = makeModel({"Test", 100.0, 100.0, 10.0, 1.5, 5, 6.0, 40.0});
+        FleetState fleet({model});
+        fleet.enableFaults(11, 5.0);
+        for (unsigned int i = 0; i < fleetSize; ++i) {
+            fleet.addVehicle(0);
+        }
+        StationNetwork stations(1, 1000, fleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 1));
+        ThreadPool pool(threads);
+        runFleetLoop(fleet, stations, nullptr, 0.1, 120.0, pool);
+
+        // Faults happen at the rate per minute of flight
+        double expectedFaults = model->totalFlightTime * 6.0 / 60.0;
+        EXPECT_NEAR(static_cast<double>(model->totalFaults), expectedFaults, 0.02 * expectedFaults);
+        EXPECT_GT(model->totalGroundedTime, 0.0);
+
+        if (referenceModels.empty()) {
+            referenceModels.push_back(model);
+            continue;
+        }
+        EXPECT_EQ(model->totalFaults, referenceModels[0]->totalFaults);
+        EXPECT_EQ(model->totalFlightTime, referenceModels[0]->totalFlightTime);
+        EXPECT_EQ(model->totalGroundedTime, referenceModels[0]->totalGroundedTime);
+    }
+}
+
+// Dropping the per vehicle totals leaves the model totals alone
+TEST(FleetStateTest, withoutVehicleTotals) {
+    const unsigned int fleetSize = 2 * FleetState::cChunkSize + 100;
+    vector<shared_ptr<ModelData>> referenceModels;
+
+    for (bool keep : {true, false}) {
+        Scenario scenario = defaultScenario();
+        VehicleModelMap modelStates;
+        initializeModels(scenario, modelStates);
+        vector<shared_ptr<ModelData>> models = modelList(modelStates);
+        FleetState fleet(models);
+        fleet.keepVehicleTotals(keep);
+        fleet.enableFaults(5, 10.0);
+        generateFleet(scenario.modelWeights, fleetSize, 42, fleet);
+        EXPECT_EQ(fleet.hasVehicleTotals(), keep);
+
+        StationNetwork stations(1, 100, fleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 1));
+        ThreadPool pool(1);
+        runFleetLoop(fleet, stations, nullptr, 0.05, 120.0, pool);
+
+        if (referenceModels.empty()) {
+            referenceModels = models;
+            continue;
+        }
+        for (size_t m = 0; m < models.size(); ++m) {
+            EXPECT_EQ(models[m]->totalFlightTime, referenceModels[m]->totalFlightTime);
+            EXPECT_EQ(models[m]->totalChargingTime, referenceModels[m]->totalChargingTime);
+            EXPECT_EQ(models[m]->totalWaitingTime, referenceModels[m]->totalWaitingTime);
+            EXPECT_EQ(models[m]->totalGroundedTime, referenceModels[m]->totalGroundedTime);
+            EXPECT_EQ(models[m]->totalFaults, referenceModels[m]->totalFaults);
+        }
+
+        // 22 bytes a vehicle, 12 more for the fault state and the scratch space for landed vehicles
+        if (!keep) {
+            EXPECT_LT(fleet.memoryUsage(), 40 * fleetSize);
+        }
+    }
+}
+
+// With the battery model a vehicle charges up to charge_to and only flies what the battery holds
+TEST(FleetStateTest, partialCharge) {
+    auto testModel = makeModel();
+    FleetState fleet({testModel});
+    fleet.enableBattery(1, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), 0.5);
+    VehicleIndex v = fleet.addVehicle(0);
+    EXPECT_DOUBLE_EQ(fleet.getStateOfCharge(v), 1.0);
+
+    vector<VehicleIndex> landed;
+    fleet.iterate(38.5, landed);
+    EXPECT_DOUBLE_EQ(fleet.getStateOfCharge(v), 0.5);
+    fleet.iterate(38.5, landed);
+    fleet.iterate(0.1, landed);
+    ASSERT_EQ(landed.size(), 1u);
+    EXPECT_NEAR(fleet.getStateOfCharge(v), 0.0, 1e-12);
+
+    // Half of the 44 minute charge
+    fleet.setCharging(v);
+    fleet.iterate(21.9, landed);
+    EXPECT_EQ(fleet.getOpState(v), OperationState::charging);
+    fleet.iterate(0.1, landed);
+    EXPECT_EQ(fleet.getOpState(v), OperationState::en_route);
+    EXPECT_DOUBLE_EQ(fleet.getStateOfCharge(v), 0.5);
+
+    // Half of the 77 minute endurance
+    landed.clear();
+    fleet.iterate(38.4, landed);
+    EXPECT_TRUE(landed.empty());
+    fleet.iterate(0.1, landed);
+    EXPECT_EQ(landed.size(), 1u);
+    EXPECT_DOUBLE_EQ(fleet.getTotalTimeCharging(v), 21.9);
+}
+
+// With trip times a vehicle flies trips back to back until its battery can't cover the next one
+TEST(FleetStateTest, trips) {
+    auto testModel = makeModel();
+    FleetState fleet({testModel});
+    fleet.enableBattery(7, 10.0, 20.0, 1.0);
+    const unsigned int fleetSize = 100;
+    for (unsigned int i = 0; i < fleetSize; ++i) {
+        fleet.addVehicle(0);
+    }
+
+    vector<VehicleIndex> landed;
+    for (int step = 0; step < 1000; ++step) {
+        fleet.iterate(0.1, landed);
+    }
+    ASSERT_EQ(landed.size(), fleetSize);
+    for (VehicleIndex v : landed) {
+        // Landed with less charge than the longest trip needs, after flying at least 57 of 77 minutes
+        double stateOfCharge = fleet.getStateOfCharge(v);
+        EXPECT_LT(stateOfCharge * 77.0, 20.0);
+        EXPECT_NEAR(fleet.getTotalTimeEnRoute(v), (1.0 - stateOfCharge) * 77.0, 0.1 * 8);
+        EXPECT_GE(fleet.getTotalTimeEnRoute(v), 57.0 - 0.1 * 8);
+    }
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#include <Geography.h>
+#include <StationNetwork.h>
+
+#include "TestModels.h"
+
+namespace {
+
+// 120 mph, so a 60 mile trip takes 30 minutes, and 100 minutes of flight on a full battery
+shared_ptr<ModelData> makeTripModel() {
+    return makeModel({"Test", 120.0, 100.0, 60.0, 1.0, 1, 0.0, 100.0});
+}
+
+// Index of the nearest point by looking at all of them, lowest index on ties
+uint32_t scanNearest(const vector<Position>& points, Position position) {
+    uint32_t best = 0;
+    for (uint32_t p = 1; p < points.size(); ++p) {
+        if (distance(points[p], position) < distance(points[best], position)) {
+            best = p;
+        }
+    }
+    return best;
+}
+
+}
+
+// Test the grid finds the same nearest point as a scan, inside and outside the points' bounding box
+TEST(GeographyTest, nearestIndex) {
+    std::default_random_engine rng(11);
+    std::uniform_real_distribution<double> coordinate(-10.0, 60.0);
+    for (size_t count : {1u, 2u, 7u, 1000u}) {
+        VertiportMap map(count, 50.0, count);
+        const vector<Position>& points = map.getPositions();
+        NearestIndex index(points);
+        for (int q = 0; q < 2000; ++q) {
+            Position position{coordinate(rng), coordinate(rng)};
+            ASSERT_EQ(index.nearest(position), scanNearest(points, position)) << count << " points";
+        }
+    }
+
+    // Points in a line, points on top of each other and ties go to the lowest index
+    NearestIndex line({{0.0, 5.0}, {10.0, 5.0}, {20.0, 5.0}, {30.0, 5.0}});
+    EXPECT_EQ(line.nearest({14.0, -3.0}), 1u);
+    EXPECT_EQ(line.nearest({15.0, 5.0}), 1u);
+    EXPECT_EQ(line.nearest({100.0, 5.0}), 3u);
+    NearestIndex stacked({{1.0, 1.0}, {1.0, 1.0}, {1.0, 1.0}});
+    EXPECT_EQ(stacked.nearest({0.0, 0.0}), 0u);
+    NearestIndex corners({{0.0, 0.0}, {10.0, 0.0}, {0.0, 10.0}, {10.0, 10.0}});
+    EXPECT_EQ(corners.nearest({5.0, 5.0}), 0u);
+    EXPECT_EQ(corners.nearest({5.0, 6.0}), 2u);
+}
+
+// Test trip destinations are spread evenly over the other vertiports
+TEST(GeographyTest, destination) {
+    VertiportMap map(5, 10.0, 1);
+    EXPECT_EQ(map.destination(0, 0.0), 1u);
+    EXPECT_EQ(map.destination(2, 0.0), 0u);
+    EXPECT_EQ(map.destination(2, 0.49), 1u);
+    EXPECT_EQ(map.destination(2, 0.5), 3u);
+    EXPECT_EQ(map.destination(4, 0.999999), 3u);
+    EXPECT_EQ(map.destination(3, 0.999999), 4u);
+}
+
+// Test a vehicle flies trips between vertiports timed by their distance, then lands for a charge at the
+// nearest station and is moved to its vertiport
+TEST(GeographyTest, fleetTrips) {
+    auto model = makeTripModel();
+    shared_ptr<const VertiportMap> map(new VertiportMap({{0.0, 0.0}, {60.0, 0.0}, {60.0, 1.0}}));
+    FleetState fleet({model});
+    fleet.enableBattery(3, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), 1.0);
+    fleet.enableVertiports(map);
+    for (int i = 0; i < 40; ++i) {
+        fleet.addVehicle(0);
+    }
+    // Starting vertiports are drawn for each vehicle
+    vector<int> starts(map->size(), 0);
+    for (VehicleIndex v = 0; v < fleet.size(); ++v) {
+        ++starts[fleet.getVertiport(v)];
+    }
+    for (int count : starts) {
+        EXPECT_GT(count, 0);
+    }
+
+    // Follow a vehicle from its start: each trip takes the distance at 120 mph, and it flies on while
+    // the battery has the charge for its next trip
+    const VehicleIndex vehicle = 0;
+    bool landed = false;
+    double flown = 0.0;
+    for (int trip = 0; !landed; ++trip) {
+        ASSERT_LT(trip, 100);
+        const VertiportIndex from = fleet.getVertiport(vehicle);
+        vector<VehicleIndex> allLanded;
+        double flight = 0.0;
+        while (fleet.getVertiport(vehicle) == from && fleet.getOpState(vehicle) == OperationState::en_route) {
+            fleet.iterate(0.25, allLanded);
+            flight += 0.25;
+        }
+        const VertiportIndex to = fleet.getVertiport(vehicle);
+        EXPECT_NE(to, from);
+        EXPECT_NEAR(flight, distance(map->position(from), map->position(to)) / 2.0, 0.25 + 1e-9);
+        flown += distance(map->position(from), map->position(to)) / 2.0;
+        landed = std::find(allLanded.begin(), allLanded.end(), vehicle) != allLanded.end();
+    }
+    EXPECT_EQ(fleet.getOpState(vehicle), OperationState::waiting_for_charge_queue);
+    EXPECT_NEAR(fleet.getStateOfCharge(vehicle), 1.0 - flown / 100.0, 1e-9);
+
+    // Stations at the first two vertiports, the one at vertiport 1 is nearest anywhere on the right
+    StationNetwork stations(2, 1, fleet.size(), makeRoutingPolicy(StationRouting::nearest_routing, 2, map.get()),
+                            true);
+    const VertiportIndex landedAt = fleet.getVertiport(vehicle);
+    stations.addVehicle(fleet, vehicle);
+    EXPECT_EQ(stations.getVehicleStation(vehicle), landedAt == 0 ? 0u : 1u);
+    EXPECT_EQ(fleet.getVertiport(vehicle), stations.getVehicleStation(vehicle));
+}
+
+// Test nearest routing goes by distance with a map and by home station without one
+TEST(GeographyTest, nearestRouting) {
+    shared_ptr<const VertiportMap> map(new VertiportMap({{0.0, 0.0}, {10.0, 0.0}, {0.0, 10.0}, {9.0, 1.0},
+                                                         {1.0, 8.0}, {4.0, 4.0}}));
+    FleetState fleet({makeTripModel()});
+    fleet.enableBattery(1, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), 1.0);
+    fleet.enableVertiports(map);
+    for (int i = 0; i < 6; ++i) {
+        fleet.addVehicle(0);
+    }
+    NearestRouting byDistance(3, map.get());
+    NearestRouting byHome(3);
+    const StationIndex expected[] = {0, 1, 2, 1, 2, 0};
+    for (VertiportIndex v = 0; v < map->size(); ++v) {
+        fleet.setVertiport(0, v);
+        EXPECT_EQ(byDistance.route(fleet, 0), expected[v]) << "vertiport " << v;
+        EXPECT_EQ(byHome.route(fleet, 4), 1u);
+    }
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include <unistd.h>
+
+#include <FleetSimulation.h>
+#include <LiveExport.h>
+
+#include "TestModels.h"
+
+namespace {
+
+// Segment names are shared by every process on the machine
+std::string segmentName(const std::string& test) {
+    return "joby_live_test_" + test + "_" + std::to_string(getpid());
+}
+
+}
+
+// Test a monitor reads the snapshots of a fleet engine run, and keeps the final one after the run ends
+TEST(LiveExportTest, fleetLoop) {
+    const std::string name = segmentName("fleet");
+    auto model = makeFlightModel();
+    FleetState fleet({model});
+    for (int i = 0; i < 4; ++i) {
+        fleet.addVehicle(0);
+    }
+    StationNetwork stations(1, 1, 4, makeRoutingPolicy(StationRouting::nearest_routing, 1));
+    ThreadPool pool(1);
+    LiveReader reader;
+    LiveSnapshot snapshot;
+    std::string error;
+    EXPECT_FALSE(reader.open(name, error));
+    {
+        LiveExport live(name, 20.0, {model});
+        ASSERT_TRUE(live.isOpen());
+        EXPECT_EQ(live.getName(), "/" + name);
+        ASSERT_TRUE(reader.open(name, error)) << error;
+        ASSERT_EQ(reader.getLabels().size(), 1u);
+        EXPECT_EQ(reader.getLabels()[0], "Test");
+        ASSERT_TRUE(reader.read(snapshot));
+        EXPECT_EQ(snapshot.sequence, 0u);
+
+        runFleetLoop(fleet, stations, nullptr, 1.0, 45.0, pool, nullptr, nullptr, nullptr, &live);
+        EXPECT_DOUBLE_EQ(live.getNextPublishTime(), 60.0);
+
+        // Same as the telemetry samples: at 0, 20 and 40 minutes and at the end of the run
+        ASSERT_TRUE(reader.read(snapshot));
+        EXPECT_EQ(snapshot.sequence, 8u);
+        EXPECT_DOUBLE_EQ(snapshot.time, 45.0);
+        EXPECT_FALSE(snapshot.finished);
+        EXPECT_EQ(snapshot.stateCounts, (vector<uint64_t>{0, 0, 3, 1, 0, 0}));
+        EXPECT_EQ(snapshot.waiting, 3u);
+        EXPECT_EQ(snapshot.charging, 1u);
+        ASSERT_EQ(snapshot.modelTotals.size(), 1u);
+        EXPECT_DOUBLE_EQ(snapshot.modelTotals[0].totalFlightTime, 156.0);
+        EXPECT_DOUBLE_EQ(snapshot.modelTotals[0].totalChargingTime, 5.0);
+        EXPECT_DOUBLE_EQ(snapshot.modelTotals[0].totalWaitingTime, 15.0);
+    }
+
+    ASSERT_TRUE(reader.read(snapshot));
+    EXPECT_TRUE(snapshot.finished);
+    EXPECT_DOUBLE_EQ(snapshot.time, 45.0);
+    EXPECT_DOUBLE_EQ(snapshot.modelTotals[0].totalFlightTime, 156.0);
+
+    // The segment is gone for new monitors
+    LiveReader lateReader;
+    EXPECT_FALSE(lateReader.open(name, error));
+    EXPECT_NE(error.find("no live export segment"), std::string::npos);
+}
+
+// Test readers only ever see whole snapshots while the simulation publishes as fast as it can
+TEST(LiveExportTest, consistentSnapshots) {
+    const std::string name = segmentName("consistent");
+    auto model = makeFlightModel();
+    vector<shared_ptr<Vehicle>> vehicles{shared_ptr<Vehicle>(new Vehicle(model))};
+    ChargingStation chargingStation(1);
+    LiveExport live(name, 1.0, {model});
+    ASSERT_TRUE(live.isOpen());
+    live.publish(0.0, vehicles, chargingStation);
+
+    std::atomic<bool> done(false);
+    std::thread publisher([&]() {
+        for (int i = 1; i <= 200000; ++i) {
+            model->totalFlightTime = i;
+            model->totalChargingTime = 2.0 * i;
+            model->totalWaitingTime = 3.0 * i;
+            live.publish(i, vehicles, chargingStation);
+        }
+        done = true;
+    });
+
+    const int cReaders = 2;
+    std::atomic<unsigned long> snapshots(0);
+    std::atomic<bool> consistent(true);
+    vector<std::thread> readers;
+    for (int r = 0; r < cReaders; ++r) {
+        readers.emplace_back([&]() {
+            LiveReader reader;
+            std::string error;
+            if (!reader.open(name, error)) {
+                consistent = false;
+                return;
+            }
+            LiveSnapshot snapshot;
+            double lastTime = 0.0;
+            bool last = false;
+            while (!last) {
+                // One more read after the publisher is done, so every reader gets at least one
+                last = done;
+                if (!reader.read(snapshot)) {
+                    continue;
+                }
+                const ModelTotals& totals = snapshot.modelTotals[0];
+                if (totals.totalFlightTime != snapshot.time || totals.totalChargingTime != 2.0 * snapshot.time ||
+                    totals.totalWaitingTime != 3.0 * snapshot.time || snapshot.time < lastTime ||
+                    snapshot.stateCounts[OperationState::en_route] != 1) {
+                    consistent = false;
+                }
+                lastTime = snapshot.time;
+                ++snapshots;
+            }
+        });
+    }
+    publisher.join();
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    EXPECT_TRUE(consistent);
+    EXPECT_GT(snapshots.load(), 0u);
+}
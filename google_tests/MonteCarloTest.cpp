@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <MonteCarlo.h>
+
+namespace {
+
+Scenario smallScenario() {
+    Scenario scenario = defaultScenario();
+    scenario.fleetSize = 20;
+    scenario.runTime = 180.0;
+    scenario.useRealTime = false;
+    scenario.increment = 0.1;
+    scenario.seed = 7;
+    scenario.replications = 6;
+    return scenario;
+}
+
+}
+
+// Test the summary of a known set of samples
+TEST(MonteCarloTest, summarize) {
+    SampleSummary summary = summarize({5.0, 1.0, 4.0, 2.0, 3.0});
+    EXPECT_DOUBLE_EQ(summary.mean, 3.0);
+    EXPECT_DOUBLE_EQ(summary.stddev, std::sqrt(2.5));
+    EXPECT_DOUBLE_EQ(summary.p5, 1.2);
+    EXPECT_DOUBLE_EQ(summary.p50, 3.0);
+    EXPECT_DOUBLE_EQ(summary.p95, 4.8);
+
+    // Missing results are skipped
+    summary = summarize({2.0, std::nan("")});
+    EXPECT_DOUBLE_EQ(summary.mean, 2.0);
+    EXPECT_DOUBLE_EQ(summary.stddev, 0.0);
+    EXPECT_TRUE(std::isnan(summarize({}).mean));
+}
+
+// Replications only depend on their seed - not on the number of threads or on reused memory
+TEST(MonteCarloTest, reproducible) {
+    Scenario scenario = smallScenario();
+    ThreadPool onePool(1);
+    ThreadPool threePool(3);
+    std::vector<ModelSamples> first = runReplications(scenario, onePool);
+    std::vector<ModelSamples> second = runReplications(scenario, threePool);
+
+    ASSERT_EQ(first.size(), scenario.models.size());
+    ASSERT_EQ(second.size(), first.size());
+    bool replicationsDiffer = false;
+    for (size_t m = 0; m < first.size(); ++m) {
+        EXPECT_EQ(first[m].label, scenario.models[m].label);
+        ASSERT_EQ(first[m].averageFlightTime.size(), scenario.replications);
+        for (unsigned int r = 0; r < scenario.replications; ++r) {
+            // NaN when the model wasn't drawn into the fleet
+            EXPECT_EQ(std::isnan(first[m].averageFlightTime[r]), std::isnan(second[m].averageFlightTime[r]));
+            if (!std::isnan(first[m].averageFlightTime[r])) {
+                EXPECT_EQ(first[m].averageFlightTime[r], second[m].averageFlightTime[r]);
+                EXPECT_EQ(first[m].averageWaitingTime[r], second[m].averageWaitingTime[r]);
+                EXPECT_EQ(first[m].averageChargingTime[r], second[m].averageChargingTime[r]);
+            }
+            EXPECT_EQ(first[m].totalPassengerMiles[r], second[m].totalPassengerMiles[r]);
+            replicationsDiffer |= first[m].totalPassengerMiles[r] != first[m].totalPassengerMiles[0];
+        }
+    }
+    EXPECT_TRUE(replicationsDiffer);
+    EXPECT_NE(replicationSeed(scenario.seed, 0), replicationSeed(scenario.seed, 1));
+}
+
+// The sessions of all the replications merge to the same sketches for any number of threads
+TEST(MonteCarloTest, sessions) {
+    Scenario scenario = smallScenario();
+    ThreadPool onePool(1);
+    ThreadPool threePool(3);
+    SessionStatistics first(scenario.models.size());
+    SessionStatistics second(scenario.models.size());
+    runReplications(scenario, onePool, &first);
+    runReplications(scenario, threePool, &second);
+
+    DurationSketch waits = first.allWaits();
+    EXPECT_GT(waits.getCount(), 0u);
+    EXPECT_GT(first.allCharges().getCount(), 0u);
+    EXPECT_EQ(second.allWaits().getCount(), waits.getCount());
+    EXPECT_EQ(second.allWaits().getTotal(), waits.getTotal());
+    EXPECT_EQ(second.allWaits().percentile(0.95), waits.percentile(0.95));
+    EXPECT_EQ(second.allCharges().percentile(0.5), first.allCharges().percentile(0.5));
+}
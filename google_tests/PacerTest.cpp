@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include <Pacer.h>
+#include <Simulation.h>
+
+// Test ticks are fixed steps of world time, spaced out on the wall clock
+TEST(PacerTest, paced) {
+    Pacer pacer(200.0, 60.0, 10);
+    EXPECT_DOUBLE_EQ(pacer.getIncrement(), 0.3);
+
+    double startTime = sysTime();
+    pacer.start();
+    double worldTime = 0.0;
+    for (int i = 0; i < 40; ++i) {
+        worldTime += pacer.next();
+    }
+    double elapsed = sysTime() - startTime;
+
+    // 40 ticks at 200 a second, 60 world minutes per second. A busy machine can make steps late but
+    // never early, so only lower bounds are checked against the wall clock.
+    EXPECT_EQ(pacer.getSteps(), 40u);
+    EXPECT_GE(pacer.getTicks(), 40u);
+    EXPECT_NEAR(worldTime, 0.3 * static_cast<double>(pacer.getTicks()), 1e-9);
+    EXPECT_GE(elapsed, static_cast<double>(pacer.getTicks()) / 200.0 * 0.99);
+}
+
+// Test a step that runs long is reported and caught up on in bounded steps
+TEST(PacerTest, catchUp) {
+    Pacer pacer(1000.0, 1.0, 5);
+    pacer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // About 20 ticks are due, the step covers the most it can
+    EXPECT_DOUBLE_EQ(pacer.next(), 0.005);
+    EXPECT_EQ(pacer.getOverruns(), 1u);
+    EXPECT_GE(pacer.getWorstLag(), 0.015);
+
+    // Catching up never covers more than 5 ticks a step, however far behind the machine runs
+    for (int i = 0; i < 50; ++i) {
+        unsigned long ticks = pacer.getTicks();
+        EXPECT_LE(pacer.next(), 0.005 + 1e-12);
+        EXPECT_GE(pacer.getTicks(), ticks + 1);
+        EXPECT_LE(pacer.getTicks(), ticks + 5);
+    }
+    EXPECT_EQ(pacer.getSteps(), 51u);
+    EXPECT_GE(pacer.getTicks(), 20u);
+    EXPECT_GT(pacer.getTicks(), pacer.getSteps());
+}
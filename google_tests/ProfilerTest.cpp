@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include <Profiler.h>
+#include <Simulation.h>
+
+#include "TestModels.h"
+
+// Test every value lands in a bucket that keeps it to within 1 part in 2^cSubBucketBits
+TEST(ProfilerTest, histogramBuckets) {
+    for (uint64_t value : {uint64_t(0), uint64_t(1), uint64_t(127), uint64_t(128), uint64_t(129), uint64_t(1000),
+                           uint64_t(123456789), uint64_t(1) << 40, UINT64_MAX}) {
+        size_t bucket = LatencyHistogram::bucketOf(value);
+        ASSERT_LT(bucket, LatencyHistogram::cNumberOfBuckets);
+        uint64_t highest = LatencyHistogram::bucketHighest(bucket);
+        EXPECT_GE(highest, value);
+        EXPECT_LE(highest - value, value >> LatencyHistogram::cSubBucketBits);
+        if (bucket > 0) {
+            // Buckets are contiguous
+            EXPECT_LT(LatencyHistogram::bucketHighest(bucket - 1), value);
+        }
+    }
+}
+
+// Test percentiles, min/max and merging
+TEST(ProfilerTest, histogramPercentiles) {
+    LatencyHistogram low;
+    LatencyHistogram high;
+    EXPECT_EQ(low.percentile(0.5), 0u);
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        low.record(value);
+        high.record(value + 1000);
+    }
+    EXPECT_EQ(low.getCount(), 1000u);
+    EXPECT_EQ(low.getMinimum(), 1u);
+    EXPECT_EQ(low.getMaximum(), 1000u);
+    EXPECT_DOUBLE_EQ(low.getMean(), 500.5);
+    EXPECT_NEAR(static_cast<double>(low.percentile(0.5)), 500.0, 5.0);
+    EXPECT_NEAR(static_cast<double>(low.percentile(0.99)), 990.0, 10.0);
+    EXPECT_EQ(low.percentile(1.0), 1000u);
+
+    low.merge(high);
+    EXPECT_EQ(low.getCount(), 2000u);
+    EXPECT_EQ(low.getMaximum(), 2000u);
+    EXPECT_NEAR(static_cast<double>(low.percentile(0.5)), 1000.0, 10.0);
+    EXPECT_NEAR(static_cast<double>(low.percentile(0.75)), 1500.0, 15.0);
+
+    low.clear();
+    EXPECT_EQ(low.getCount(), 0u);
+    EXPECT_EQ(low.getMinimum(), 0u);
+}
+
+// Test the transition counts, summary and trace of a profiler fed by hand
+TEST(ProfilerTest, summaryAndTrace) {
+    const std::string path = testing::TempDir() + "profiler_test.json";
+    auto model = makeFlightModel();
+    auto other = makeFlightModel();
+    Profiler profiler({model}, true);
+    profiler.countTransition(model.get(), en_route, waiting_for_charge_queue);
+    profiler.countTransition(model.get(), en_route, waiting_for_charge_queue);
+    profiler.countTransition(other.get(), charging, en_route);
+    profiler.recordPhase(ProfilePhase::vehicle_iteration, 1000, 3500);
+    profiler.recordPhase(ProfilePhase::station_iteration, 3500, 4000);
+
+    EXPECT_EQ(profiler.getTransitions(0, en_route, waiting_for_charge_queue), 2u);
+    EXPECT_EQ(profiler.getTransitions(0, charging, en_route), 0u);
+    EXPECT_EQ(profiler.getPhase(ProfilePhase::vehicle_iteration).getTotal(), 2500u);
+    EXPECT_EQ(profiler.getNumberOfTraceEvents(), 2u);
+
+    std::ostringstream summary;
+    profiler.printSummary(summary);
+    EXPECT_NE(summary.str().find("vehicle_iteration: 1/2.500/"), std::string::npos);
+    EXPECT_EQ(summary.str().find("landing_shuffle"), std::string::npos);
+    EXPECT_NE(summary.str().find("Test: en_route->waiting_for_charge_queue=2\n"), std::string::npos);
+
+    std::string error;
+    ASSERT_TRUE(profiler.writeTrace(path, error)) << error;
+    std::ifstream file(path);
+    std::stringstream trace;
+    trace << file.rdbuf();
+    EXPECT_EQ(trace.str().find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+    EXPECT_NE(trace.str().find("{\"name\":\"vehicle_iteration\",\"cat\":\"simulation\",\"ph\":\"X\",\"ts\":1.000,"
+                               "\"dur\":2.500,\"pid\":1,\"tid\":1},"), std::string::npos);
+    EXPECT_NE(trace.str().find("\"ts\":3.500,\"dur\":0.500"), std::string::npos);
+}
+
+// Test the tick engine's phases and transitions are recorded into the active profiler, in a profiling
+// build, and that nothing is recorded otherwise
+TEST(ProfilerTest, tickLoop) {
+    auto model = makeFlightModel();
+    VehicleModelMap models{{0, model}};
+    RandomStream rng(1);
+    vector<shared_ptr<Vehicle>> vehicles = generateFleet(models, {1.0}, 4, 1);
+    ChargingStation chargingStation(1);
+
+    Profiler profiler({model}, false);
+    profiler.activate();
+    unsigned long passes = runTickLoop(vehicles, chargingStation, nullptr, 1.0, 60.0, rng, nullptr, false);
+    Profiler::deactivate();
+    EXPECT_EQ(Profiler::active(), nullptr);
+
+    uint64_t expectedPasses = cProfilingBuild ? passes : 0;
+    uint64_t expectedLandings = cProfilingBuild ? 4 : 0;
+    EXPECT_EQ(profiler.getPhase(ProfilePhase::simulation_pass).getCount(), expectedPasses);
+    EXPECT_EQ(profiler.getPhase(ProfilePhase::vehicle_iteration).getCount(), expectedPasses);
+    EXPECT_EQ(profiler.getPhase(ProfilePhase::station_iteration).getCount(), expectedPasses);
+    // All four land together on the 40th pass and charge one at a time for 10 passes, so by the 60th
+    // two have finished and a third has started
+    EXPECT_EQ(profiler.getPhase(ProfilePhase::landing_shuffle).getCount(), cProfilingBuild ? 1u : 0u);
+    EXPECT_EQ(profiler.getTransitions(0, en_route, waiting_for_charge_queue), expectedLandings);
+    EXPECT_EQ(profiler.getTransitions(0, waiting_for_charge_queue, in_charge_queue), expectedLandings);
+    EXPECT_EQ(profiler.getTransitions(0, in_charge_queue, charging), cProfilingBuild ? 3u : 0u);
+    EXPECT_EQ(profiler.getTransitions(0, charging, en_route), cProfilingBuild ? 2u : 0u);
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <RandomStream.h>
+
+// Test stream 0 is SplitMix64 and the other streams and seeds are different draws
+TEST(RandomStreamTest, draws) {
+    // The first outputs of SplitMix64 seeded with 0
+    EXPECT_EQ(randomBits(0, 0, 0), 0xE220A8397B1DCDAFULL);
+    EXPECT_EQ(randomBits(0, 1, 0), 0x6E789E6AA1B965F4ULL);
+    EXPECT_NE(randomBits(0, 0, 1), randomBits(0, 0, 0));
+    EXPECT_NE(randomBits(1, 0, 0), randomBits(0, 0, 0));
+
+    double sum = 0.0;
+    const uint32_t draws = 100000;
+    for (uint32_t number = 0; number < draws; ++number) {
+        double draw = uniformDraw(42, 7, number);
+        ASSERT_GE(draw, 0.0);
+        ASSERT_LT(draw, 1.0);
+        sum += draw;
+    }
+    EXPECT_NEAR(sum / draws, 0.5, 0.005);
+}
+
+// Test a stream makes the keyed draws in turn, and a copy carries on from the same place
+TEST(RandomStreamTest, stream) {
+    RandomStream stream(42, 7);
+    EXPECT_EQ(stream(), randomBits(42, 7, 0));
+    EXPECT_EQ(stream.uniform(), uniformDraw(42, 7, 1));
+    EXPECT_EQ(stream.getCount(), 2u);
+
+    RandomStream copy = stream;
+    EXPECT_EQ(copy(), stream());
+
+    // Works with the standard algorithms
+    std::vector<int> values(20);
+    std::iota(values.begin(), values.end(), 0);
+    std::vector<int> shuffled = values;
+    RandomStream first(3);
+    std::shuffle(shuffled.begin(), shuffled.end(), first);
+    EXPECT_NE(shuffled, values);
+    std::vector<int> again = values;
+    RandomStream second(3);
+    std::shuffle(again.begin(), again.end(), second);
+    EXPECT_EQ(again, shuffled);
+}
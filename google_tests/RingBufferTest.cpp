@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+
+#include <RingBuffer.h>
+
+// Test FIFO order across the wrap around
+TEST(RingBufferTest, pushAndPop) {
+    RingBuffer<int> buffer(3);
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.capacity(), 3u);
+
+    for (int round = 0; round < 4; ++round) {
+        buffer.push(round * 10 + 1);
+        buffer.push(round * 10 + 2);
+        EXPECT_EQ(buffer.size(), 2u);
+        EXPECT_EQ(buffer.front(), round * 10 + 1);
+        buffer.pop();
+        EXPECT_EQ(buffer.front(), round * 10 + 2);
+        buffer.pop();
+        EXPECT_TRUE(buffer.empty());
+    }
+
+    buffer.push(1);
+    buffer.push(2);
+    buffer.push(3);
+    EXPECT_TRUE(buffer.full());
+    buffer.clear();
+    EXPECT_TRUE(buffer.empty());
+    buffer.push(4);
+    EXPECT_EQ(buffer.front(), 4);
+}
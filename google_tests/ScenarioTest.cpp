@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include <Scenario.h>
+
+namespace {
+
+// Write a scenario file to a temporary path
+std::string writeScenario(const std::string& contents) {
+    std::string path = testing::TempDir() + "scenario_test.ini";
+    std::ofstream file(path);
+    file << contents;
+    return path;
+}
+
+}
+
+// The built in scenario is what main() used to hard-code
+TEST(ScenarioTest, defaults) {
+    Scenario scenario = defaultScenario();
+    EXPECT_EQ(scenario.models.size(), 5u);
+    EXPECT_EQ(scenario.modelWeights.size(), 5u);
+    EXPECT_EQ(scenario.models[0].label, "Alpha");
+    EXPECT_EQ(scenario.fleetSize, 20u);
+    EXPECT_EQ(scenario.numberOfChargingSlots, 3);
+    EXPECT_DOUBLE_EQ(scenario.runTime, 180.0);
+    EXPECT_TRUE(scenario.useRealTime);
+    EXPECT_EQ(scenario.engine, SimulationEngine::tick_engine);
+}
+
+// Settings and models are read from the file, models replace the built in ones
+TEST(ScenarioTest, load) {
+    std::string path = writeScenario(
+            "; comment\n"
+            "[simulation]\n"
+            "duration = 60   # an hour\n"
+            "step = fixed\n"
+            "increment = 0.5\n"
+            "engine = fleet\n"
+            "threads = 4\n"
+            "seed = 42\n"
+            "fleet_size = 1000\n"
+            "chargers = 7\n"
+            "\n"
+            "[model Test]\n"
+            "cruise_speed = 100\n"
+            "battery_capacity = 100\n"
+            "time_to_charge = 12\n"
+            "energy_use = 1.5\n"
+            "passengers = 5\n"
+            "faults_per_hour = 0.1\n"
+            "weight = 3\n"
+            "[model Other]\n"
+            "cruise_speed = 50\n"
+            "battery_capacity = 100\n"
+            "time_to_charge = 10\n"
+            "energy_use = 1\n"
+            "passengers = 2\n"
+            "faults_per_hour = 0\n"
+            "endurance = 30\n");
+
+    Scenario scenario = defaultScenario();
+    std::string error;
+    ASSERT_TRUE(loadScenario(path, scenario, error)) << error;
+    std::remove(path.c_str());
+
+    EXPECT_DOUBLE_EQ(scenario.runTime, 60.0);
+    EXPECT_FALSE(scenario.useRealTime);
+    EXPECT_DOUBLE_EQ(scenario.increment, 0.5);
+    EXPECT_EQ(scenario.engine, SimulationEngine::fleet_engine);
+    EXPECT_EQ(scenario.numberOfThreads, 4u);
+    EXPECT_EQ(scenario.seed, 42u);
+    EXPECT_EQ(scenario.fleetSize, 1000u);
+    EXPECT_EQ(scenario.numberOfChargingSlots, 7);
+
+    ASSERT_EQ(scenario.models.size(), 2u);
+    EXPECT_EQ(scenario.models[0].label, "Test");
+    EXPECT_EQ(scenario.models[0].passengerCount, 5u);
+    EXPECT_DOUBLE_EQ(scenario.models[0].endurance, 40.0); // Worked out from the battery
+    EXPECT_DOUBLE_EQ(scenario.modelWeights[0], 3.0);
+    EXPECT_EQ(scenario.models[1].label, "Other");
+    EXPECT_DOUBLE_EQ(scenario.models[1].endurance, 30.0);
+    EXPECT_DOUBLE_EQ(scenario.modelWeights[1], 1.0);
+}
+
+// Errors point at the offending line
+TEST(ScenarioTest, errors) {
+    Scenario scenario = defaultScenario();
+    std::string error;
+    EXPECT_FALSE(loadScenario(testing::TempDir() + "no_such_scenario.ini", scenario, error));
+
+    std::string path = writeScenario("[simulation]\nduration = soon\n");
+    EXPECT_FALSE(loadScenario(path, scenario, error));
+    EXPECT_NE(error.find(":2:"), std::string::npos) << error;
+
+    path = writeScenario("[model Broken]\ncruise_speed = 100\n");
+    EXPECT_FALSE(loadScenario(path, scenario, error));
+
+    // Flights and charges that take no time
+    const std::string instant = "[model Instant]\ncruise_speed = 100\nbattery_capacity = 100\nenergy_use = 1.5\n"
+                                "passengers = 5\nfaults_per_hour = 0.1\n";
+    path = writeScenario(instant + "time_to_charge = 0\n");
+    EXPECT_FALSE(loadScenario(path, scenario, error));
+    path = writeScenario(instant + "time_to_charge = 10\nendurance = 0\n");
+    EXPECT_FALSE(loadScenario(path, scenario, error));
+    EXPECT_NE(error.find("endurance above 0"), std::string::npos) << error;
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(applySetting(scenario, "engine", "warp", error));
+    EXPECT_FALSE(applySetting(scenario, "no_such_setting", "1", error));
+    EXPECT_TRUE(applySetting(scenario, "fleet_size", "50", error));
+    EXPECT_EQ(scenario.fleetSize, 50u);
+
+    // Counts too big for their fields
+    EXPECT_FALSE(applySetting(scenario, "chargers", "2147483648", error));
+    EXPECT_EQ(error, "chargers can't be over 2147483647: 2147483648");
+    EXPECT_FALSE(applySetting(scenario, "fleet_size", "4294967296", error));
+    EXPECT_FALSE(applySetting(scenario, "threads", "99999999999999999999", error));
+    EXPECT_EQ(scenario.fleetSize, 50u);
+    path = writeScenario("[simulation]\nfleet_size = 10\nreplications = 4294967296\n");
+    EXPECT_FALSE(loadScenario(path, scenario, error));
+    EXPECT_NE(error.find(":3: replications can't be over"), std::string::npos) << error;
+    std::remove(path.c_str());
+}
+
+// Sweep lists take counts, ranges and sets of weights
+TEST(ScenarioTest, sweepLists) {
+    Scenario scenario = defaultScenario();
+    std::string error;
+    EXPECT_TRUE(applySetting(scenario, "sweep_chargers", "1:3, 8, 10:20:5", error)) << error;
+    EXPECT_EQ(scenario.sweepChargers, (std::vector<unsigned int>{1, 2, 3, 8, 10, 15, 20}));
+    EXPECT_TRUE(applySetting(scenario, "sweep_weights", "1 1 2, 0 4 0", error)) << error;
+    ASSERT_EQ(scenario.sweepWeights.size(), 2u);
+    EXPECT_EQ(scenario.sweepWeights[1], (std::vector<double>{0, 4, 0}));
+
+    EXPECT_FALSE(applySetting(scenario, "sweep_fleet_size", "10:20:0", error));
+    EXPECT_FALSE(applySetting(scenario, "sweep_fleet_size", "1:2:3:4", error));
+    EXPECT_FALSE(applySetting(scenario, "sweep_fleet_size", "ten", error));
+    EXPECT_FALSE(applySetting(scenario, "sweep_weights", "0 0 0", error));
+
+    // Ranges are capped so they can't expand to billions of runs
+    EXPECT_TRUE(applySetting(scenario, "sweep_fleet_size", "1:10000", error)) << error;
+    EXPECT_EQ(scenario.sweepFleetSizes.size(), 10000u);
+    EXPECT_FALSE(applySetting(scenario, "sweep_fleet_size", "1:10000,20000", error));
+    EXPECT_FALSE(applySetting(scenario, "sweep_fleet_size", "0:4294967295", error));
+    EXPECT_FALSE(applySetting(scenario, "sweep_chargers", "2147483648", error));
+}
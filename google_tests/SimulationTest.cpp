@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <Simulation.h>
+
+#include "TestModels.h"
+
+// Test vehicles landing on the same pass are equally likely to be first in the charging queue
+TEST(SimulationTest, tieBreak) {
+    auto model = makeFlightModel();
+    RandomStream rng(3);
+    const int trials = 3000;
+    int firstCharged[3] = {0, 0, 0};
+    for (int trial = 0; trial < trials; ++trial) {
+        vector<shared_ptr<Vehicle>> vehicles;
+        for (int i = 0; i < 3; ++i) {
+            vehicles.push_back(shared_ptr<Vehicle>(new Vehicle(model)));
+        }
+        ChargingStation chargingStation(1);
+        vector<shared_ptr<Vehicle>> landed;
+
+        // The whole flight in one pass, all three land together and one gets the charger
+        stepTick(vehicles, chargingStation, 50.0, rng, landed);
+        EXPECT_EQ(chargingStation.getNumberCharging(), 1u);
+        EXPECT_EQ(chargingStation.getNumberWaiting(), 2u);
+        for (int i = 0; i < 3; ++i) {
+            if (vehicles[i]->getOpState() == OperationState::charging) {
+                ++firstCharged[i];
+            }
+        }
+    }
+    for (int count : firstCharged) {
+        EXPECT_NEAR(count, trials / 3, 100);
+    }
+}
+
+// Test jumping over quiet passes gives the same run as stepping every pass
+TEST(SimulationTest, fastForward) {
+    Scenario scenario = defaultScenario();
+    for (int chargers : {3, 20}) {
+        VehicleModelMap steppedModels;
+        VehicleModelMap skippedModels;
+        initializeModels(scenario, steppedModels);
+        initializeModels(scenario, skippedModels);
+        RandomStream steppedRng(8);
+        RandomStream skippedRng(8);
+        vector<shared_ptr<Vehicle>> stepped = generateFleet(steppedModels, scenario.modelWeights, 20, 8);
+        vector<shared_ptr<Vehicle>> skipped = generateFleet(skippedModels, scenario.modelWeights, 20, 8);
+        ChargingStation steppedStation(chargers);
+        ChargingStation skippedStation(chargers);
+
+        unsigned long passes = runTickLoop(stepped, steppedStation, nullptr, 0.01, 180.0, steppedRng);
+        EXPECT_EQ(runTickLoop(skipped, skippedStation, nullptr, 0.01, 180.0, skippedRng, nullptr, true), passes);
+
+        for (size_t v = 0; v < stepped.size(); ++v) {
+            EXPECT_EQ(skipped[v]->getOpState(), stepped[v]->getOpState());
+        }
+        for (auto model : steppedModels) {
+            const ModelData& skippedModel = *skippedModels[model.first];
+            EXPECT_NEAR(skippedModel.totalFlightTime, model.second->totalFlightTime, 1e-6);
+            EXPECT_NEAR(skippedModel.totalChargingTime, model.second->totalChargingTime, 1e-6);
+            EXPECT_NEAR(skippedModel.totalWaitingTime, model.second->totalWaitingTime, 1e-6);
+        }
+    }
+}
+
+// Test each vehicle's model comes from its own draw: the same fleet on one thread, across a pool, and
+// added in pieces, with the models in proportion to their weights
+TEST(SimulationTest, fleetDraws) {
+    const vector<double> weights{1.0, 0.0, 3.0};
+    const unsigned int fleetSize = 200000;
+    vector<ModelIndex> models = drawFleetModels(weights, fleetSize, 17);
+    ThreadPool pool(4);
+    EXPECT_EQ(drawFleetModels(weights, fleetSize, 17, &pool), models);
+    EXPECT_NE(drawFleetModels(weights, fleetSize, 18), models);
+
+    vector<size_t> counts(weights.size(), 0);
+    for (ModelIndex model : models) {
+        ++counts[model];
+    }
+    EXPECT_EQ(counts[1], 0u);
+    EXPECT_NEAR(static_cast<double>(counts[2]) / fleetSize, 0.75, 0.005);
+
+    auto model = makeFlightModel();
+    FleetState fleet({model, model, model});
+    generateFleet(weights, 1000, 17, fleet);
+    generateFleet(weights, 2000, 17, fleet, &pool);
+    ASSERT_EQ(fleet.size(), 3000u);
+    for (VehicleIndex v = 0; v < fleet.size(); ++v) {
+        ASSERT_EQ(fleet.getModel(v), models[v]) << v;
+    }
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include <FleetSimulation.h>
+#include <Simulation.h>
+#include <StaticFleet.h>
+
+// Test the built in static models are the models of the default scenario
+TEST(StaticFleetTest, defaultModels) {
+    Scenario scenario = defaultScenario();
+    EXPECT_TRUE(DefaultStaticFleet::hasModels(scenario.models));
+    vector<ModelParameters> models = DefaultStaticFleet::modelParameters();
+    ASSERT_EQ(models.size(), scenario.models.size());
+    for (size_t m = 0; m < models.size(); ++m) {
+        EXPECT_EQ(models[m].label, scenario.models[m].label);
+        EXPECT_EQ(models[m].endurance, scenario.models[m].endurance);
+    }
+
+    // Any change to the models, or to their order, needs the runtime engines
+    vector<ModelParameters> reversed(scenario.models.rbegin(), scenario.models.rend());
+    EXPECT_FALSE(DefaultStaticFleet::hasModels(reversed));
+    vector<ModelParameters> fewer(scenario.models.begin(), scenario.models.end() - 1);
+    EXPECT_FALSE(DefaultStaticFleet::hasModels(fewer));
+}
+
+// Test the static engine queues and charges the same as the fleet engine with one station
+TEST(StaticFleetTest, matchesFleetEngine) {
+    Scenario scenario = defaultScenario();
+    const unsigned int fleetSize = 1000;
+    const unsigned int slots = 20;
+    VehicleModelMap modelStates;
+    initializeModels(scenario, modelStates);
+    vector<ModelIndex> fleetModels = drawFleetModels(scenario.modelWeights, fleetSize, 7);
+
+    FleetState fleet(modelList(modelStates));
+    DefaultStaticFleet staticFleet(slots);
+    for (ModelIndex model : fleetModels) {
+        fleet.addVehicle(model);
+        staticFleet.addVehicle(model);
+    }
+    StationNetwork stations(1, slots, fleetSize, makeRoutingPolicy(StationRouting::nearest_routing, 1));
+    ThreadPool pool(1);
+
+    unsigned long passes = runFleetLoop(fleet, stations, nullptr, 0.1, 300.0, pool);
+    EXPECT_EQ(runStaticLoop(staticFleet, nullptr, 0.1, 300.0), passes);
+    EXPECT_EQ(staticFleet.getNumberCharging(), stations.getNumberCharging());
+    EXPECT_EQ(staticFleet.getNumberWaiting(), stations.getNumberWaiting());
+
+    for (ModelIndex m = 0; m < DefaultStaticFleet::cNumberOfModels; ++m) {
+        const ModelData& expected = *modelStates[m];
+        ModelTotals totals = staticFleet.getTotals(m);
+        EXPECT_EQ(staticFleet.size(m), expected.fleetCount);
+        // Summed in a different order
+        EXPECT_NEAR(totals.totalFlightTime, expected.totalFlightTime, 1e-9 * expected.totalFlightTime);
+        EXPECT_NEAR(totals.totalChargingTime, expected.totalChargingTime, 1e-9 * expected.totalChargingTime);
+        EXPECT_NEAR(totals.totalWaitingTime, expected.totalWaitingTime, 1e-9 * expected.totalWaitingTime + 1e-9);
+    }
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include <StationNetwork.h>
+#include <FleetSimulation.h>
+
+#include "TestModels.h"
+
+// Test the wait queue threaded through the fleet is first in first out
+TEST(StationNetworkTest, stationQueue) {
+    FleetState fleet({makeFlightModel()});
+    for (int i = 0; i < 5; ++i) {
+        fleet.addVehicle(0);
+    }
+    FleetChargingStation station(2);
+    for (VehicleIndex v : {3u, 1u, 4u, 0u}) {
+        station.addVehicle(fleet, v);
+    }
+    EXPECT_EQ(station.getNumberWaiting(), 4u);
+
+    station.iterate(fleet);
+    EXPECT_EQ(station.getNumberCharging(), 2u);
+    EXPECT_TRUE(fleet.isCharging(3));
+    EXPECT_TRUE(fleet.isCharging(1));
+    EXPECT_EQ(fleet.getOpState(4), OperationState::in_charge_queue);
+
+    // Finish the charges, the next two in line take the slots
+    vector<VehicleIndex> landed;
+    vector<VehicleIndex> charged;
+    fleet.iterate(10.0, landed, charged);
+    EXPECT_EQ(charged, (vector<VehicleIndex>{1, 3}));
+    station.iterate(fleet);
+    EXPECT_TRUE(fleet.isCharging(4));
+    EXPECT_TRUE(fleet.isCharging(0));
+    EXPECT_EQ(station.getNumberWaiting(), 0u);
+}
+
+// Test the routing policies
+TEST(StationNetworkTest, routing) {
+    FleetState fleet({makeFlightModel()});
+    for (int i = 0; i < 8; ++i) {
+        fleet.addVehicle(0);
+    }
+    NearestRouting nearest(3);
+    EXPECT_EQ(nearest.route(fleet, 0), 0u);
+    EXPECT_EQ(nearest.route(fleet, 4), 1u);
+
+    RoundRobinRouting roundRobin(3);
+    EXPECT_EQ(roundRobin.route(fleet, 7), 0u);
+    EXPECT_EQ(roundRobin.route(fleet, 7), 1u);
+    EXPECT_EQ(roundRobin.route(fleet, 7), 2u);
+    EXPECT_EQ(roundRobin.route(fleet, 7), 0u);
+    roundRobin.reset();
+    EXPECT_EQ(roundRobin.route(fleet, 7), 0u);
+
+    // Check the heap against the lightest station found by a scan
+    const StationIndex stations = 37;
+    LeastQueuedRouting leastQueued(stations);
+    vector<size_t> load(stations, 0);
+    std::default_random_engine rng(5);
+    for (int i = 0; i < 2000; ++i) {
+        StationIndex lightest = 0;
+        for (StationIndex s = 1; s < stations; ++s) {
+            if (load[s] < load[lightest]) {
+                lightest = s;
+            }
+        }
+        ASSERT_EQ(leastQueued.route(fleet, 0), lightest);
+
+        StationIndex changed = static_cast<StationIndex>(rng() % stations);
+        load[changed] = rng() % 10;
+        leastQueued.loadChanged(changed, load[changed]);
+    }
+}
+
+// Test vehicles are spread over the stations and the fleet engine results still add up
+TEST(StationNetworkTest, network) {
+    const unsigned int fleetSize = 60;
+    auto model = makeFlightModel();
+    FleetState fleet({model});
+    for (unsigned int i = 0; i < fleetSize; ++i) {
+        fleet.addVehicle(0);
+    }
+    StationNetwork stations(4, 1, fleetSize, makeRoutingPolicy(StationRouting::least_queued_routing, 4));
+    ThreadPool pool(1);
+    runFleetLoop(fleet, stations, nullptr, 0.5, 45.0, pool);
+
+    // All the vehicles landed together, least queued spread them evenly
+    for (StationIndex s = 0; s < stations.size(); ++s) {
+        EXPECT_EQ(stations.getStation(s).getNumberCharging() + stations.getStation(s).getNumberWaiting(),
+                  fleetSize / 4);
+    }
+    EXPECT_EQ(stations.getVehicleStation(0), 0u);
+    EXPECT_EQ(stations.getVehicleStation(5), 1u);
+
+    // Every vehicle flew 40 minutes, then 4 charged and the rest waited for the last 5. As in the tick
+    // engine the step that ends the flight isn't counted.
+    EXPECT_NEAR(model->totalFlightTime, fleetSize * 39.5, 1e-6);
+    EXPECT_NEAR(model->totalChargingTime, 4 * 5.0, 1e-6);
+    EXPECT_NEAR(model->totalWaitingTime, (fleetSize - 4) * 5.0, 1e-6);
+}
+
+// A station serving by charge need takes the emptiest battery first
+TEST(StationNetworkTest, needQueue) {
+    FleetState fleet({makeFlightModel()});
+    // A 40 minute battery can't fly a second trip of 30 to 60 minutes, so every vehicle lands after one
+    // trip with what is left over
+    fleet.enableBattery(3, 30.0, 60.0, 1.0);
+    const unsigned int fleetSize = 20;
+    for (unsigned int i = 0; i < fleetSize; ++i) {
+        fleet.addVehicle(0);
+    }
+    vector<VehicleIndex> landed;
+    vector<VehicleIndex> charged;
+    fleet.iterate(100.0, landed, charged);
+    ASSERT_EQ(landed.size(), fleetSize);
+
+    FleetChargingStation station(1, true, fleetSize);
+    for (VehicleIndex v : landed) {
+        station.addVehicle(fleet, v);
+    }
+    vector<double> served;
+    for (unsigned int i = 0; i < fleetSize; ++i) {
+        station.iterate(fleet);
+        ASSERT_EQ(station.getNumberCharging(), 1u);
+        for (VehicleIndex v = 0; v < fleetSize; ++v) {
+            if (fleet.isCharging(v)) {
+                served.push_back(fleet.getStateOfCharge(v));
+            }
+        }
+        fleet.iterate(100.0, landed, charged);
+    }
+    ASSERT_EQ(served.size(), fleetSize);
+    EXPECT_TRUE(std::is_sorted(served.begin(), served.end()));
+    EXPECT_LT(served.front(), served.back());
+}
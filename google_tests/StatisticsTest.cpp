@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include <FleetState.h>
+#include <Statistics.h>
+
+#include "TestModels.h"
+
+// Test durations are kept to within the sketch's precision and sketches merge
+TEST(StatisticsTest, durationSketch) {
+    DurationSketch sketch;
+    EXPECT_EQ(sketch.percentile(0.5), 0.0);
+    for (int minute = 1; minute <= 100; ++minute) {
+        sketch.record(minute * 0.5);
+    }
+    // Rounding below 0 counts as 0
+    sketch.record(-1e-12);
+    EXPECT_EQ(sketch.getCount(), 101u);
+    EXPECT_DOUBLE_EQ(sketch.getMinimum(), 0.0);
+    EXPECT_NEAR(sketch.getTotal(), 2525.0, 1e-9);
+    EXPECT_NEAR(sketch.getMaximum(), 50.0, 1e-9);
+    EXPECT_NEAR(sketch.percentile(0.5), 25.0, 25.0 / 128);
+    EXPECT_NEAR(sketch.percentile(0.99), 49.5, 49.5 / 128);
+
+    DurationSketch other;
+    other.record(1000.0);
+    sketch.merge(other);
+    EXPECT_EQ(sketch.getCount(), 102u);
+    EXPECT_NEAR(sketch.percentile(1.0), 1000.0, 1e-9);
+    sketch.clear();
+    EXPECT_EQ(sketch.getCount(), 0u);
+}
+
+// Test the fleet records the wait from joining a queue and the length of each charging session
+TEST(StatisticsTest, fleetSessions) {
+    auto testModel = makeModel();
+    FleetState fleet({testModel});
+    SessionStatistics sessions(1);
+    fleet.recordSessions(&sessions);
+    VehicleIndex first = fleet.addVehicle(0);
+    VehicleIndex second = fleet.addVehicle(0);
+
+    vector<VehicleIndex> landed;
+    fleet.iterate(76.0, landed);
+    // Lands 0.5 minutes into the step, the overrun isn't part of the wait
+    fleet.iterate(1.5, landed);
+    ASSERT_EQ(landed.size(), 2u);
+    fleet.setInWaitQueue(first);
+    fleet.setInWaitQueue(second);
+    fleet.setCharging(first);
+    for (int step = 0; step < 44; ++step) {
+        fleet.iterate(1.0, landed);
+    }
+    fleet.setCharging(second);
+
+    EXPECT_EQ(sessions.getWaits(0).getCount(), 2u);
+    EXPECT_NEAR(sessions.getWaits(0).getMinimum(), 0.0, 1e-9);
+    EXPECT_NEAR(sessions.getWaits(0).getMaximum(), 44.0, 1e-9);
+    EXPECT_EQ(sessions.getCharges(0).getCount(), 1u);
+    EXPECT_NEAR(sessions.getCharges(0).getTotal(), 44.0, 1e-9);
+
+    std::ostringstream out;
+    sessions.print(out, {testModel->params});
+    EXPECT_NE(out.str().find("  Test wait: 2/22.000/"), std::string::npos);
+    EXPECT_NE(out.str().find("  Test charge: 1/44.000/"), std::string::npos);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include <Sweep.h>
+
+namespace {
+
+Scenario sweepScenario() {
+    Scenario scenario = defaultScenario();
+    scenario.useRealTime = false;
+    scenario.increment = 0.1;
+    scenario.seed = 5;
+    scenario.sweepChargers = {1, 4, 40};
+    scenario.sweepFleetSizes = {20, 100};
+    scenario.sweepWeights = {{1, 1, 1, 1, 1}, {0, 0, 1, 0, 0}};
+    return scenario;
+}
+
+}
+
+// Test the grid covers every combination, charging slots varying fastest
+TEST(SweepTest, cells) {
+    Scenario scenario = sweepScenario();
+    std::vector<SweepCell> cells = sweepCells(scenario);
+    ASSERT_EQ(cells.size(), 12u);
+    EXPECT_EQ(cells[0].numberOfChargingSlots, 1u);
+    EXPECT_EQ(cells[1].numberOfChargingSlots, 4u);
+    EXPECT_EQ(cells[3].fleetSize, 100u);
+    EXPECT_EQ(cells[6].modelWeights, (std::vector<double>{0, 0, 1, 0, 0}));
+
+    // Lists that aren't swept take the scenario setting
+    scenario.sweepFleetSizes.clear();
+    scenario.sweepWeights.clear();
+    cells = sweepCells(scenario);
+    ASSERT_EQ(cells.size(), 3u);
+    EXPECT_EQ(cells[2].fleetSize, scenario.fleetSize);
+    EXPECT_EQ(cells[2].modelWeights, scenario.modelWeights);
+}
+
+// Test cells run in parallel match the same cells run one by one, and more chargers means less waiting
+TEST(SweepTest, run) {
+    Scenario scenario = sweepScenario();
+    ThreadPool pool(3);
+    std::vector<SweepResult> results = runSweepCells(scenario, pool);
+    std::vector<SweepCell> cells = sweepCells(scenario);
+    ASSERT_EQ(results.size(), cells.size());
+    for (size_t c = 0; c < cells.size(); ++c) {
+        SweepResult single = runSweepCell(scenario, cells[c]);
+        EXPECT_EQ(results[c].cell.fleetSize, cells[c].fleetSize);
+        EXPECT_EQ(results[c].averageWaitingTime, single.averageWaitingTime);
+        EXPECT_FALSE(results[c].saturated);
+        EXPECT_DOUBLE_EQ(results[c].runTime, scenario.runTime);
+    }
+    EXPECT_GT(results[3].averageWaitingTime, results[4].averageWaitingTime);
+    EXPECT_EQ(results[2].averageWaitingTime, 0.0);
+    // Only Charlie in the fleet
+    EXPECT_EQ(results[6].models[2].fleetCount, 20u);
+    EXPECT_EQ(results[6].models[0].fleetCount, 0u);
+}
+
+// Test a cell stops once its average wait can't end up under the limit, and cells under it run to the end
+TEST(SweepTest, saturated) {
+    Scenario scenario = sweepScenario();
+    scenario.sweepMaxWait = 5.0;
+    SweepResult busy = runSweepCell(scenario, {1, 100, scenario.modelWeights});
+    EXPECT_TRUE(busy.saturated);
+    EXPECT_LT(busy.runTime, scenario.runTime);
+    EXPECT_GT(busy.averageWaitingTime, 5.0);
+
+    SweepResult idle = runSweepCell(scenario, {40, 20, scenario.modelWeights});
+    EXPECT_FALSE(idle.saturated);
+    EXPECT_DOUBLE_EQ(idle.runTime, scenario.runTime);
+
+    std::stringstream csv;
+    writeSweepCsv(csv, scenario, {busy, idle});
+    std::string line;
+    std::getline(csv, line);
+    EXPECT_EQ(line.find("chargers,fleet_size,weights,saturated,run_time,average_waiting,Alpha_vehicles,Alpha_flight,"),
+              0u);
+    std::getline(csv, line);
+    EXPECT_EQ(line.find("1,100,1 1 1 1 1,1,"), 0u);
+    std::getline(csv, line);
+    EXPECT_EQ(line.find("40,20,1 1 1 1 1,0,180,0,"), 0u);
+}
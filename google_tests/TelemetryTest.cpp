@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <FleetSimulation.h>
+#include <Simulation.h>
+#include <Telemetry.h>
+
+#include "TestModels.h"
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+}
+
+// Test a CSV time series of a fleet engine run
+TEST(TelemetryTest, csv) {
+    const std::string path = testing::TempDir() + "telemetry_test.csv";
+    auto model = makeFlightModel();
+    FleetState fleet({model});
+    for (int i = 0; i < 4; ++i) {
+        fleet.addVehicle(0);
+    }
+    StationNetwork stations(1, 1, 4, makeRoutingPolicy(StationRouting::nearest_routing, 1));
+    ThreadPool pool(1);
+    {
+        Telemetry telemetry(path, 20.0, {model});
+        ASSERT_TRUE(telemetry.isOpen());
+        runFleetLoop(fleet, stations, nullptr, 1.0, 45.0, pool, &telemetry);
+    }
+
+    std::stringstream csv(readFile(path));
+    std::string line;
+    std::getline(csv, line);
+    EXPECT_EQ(line, "time,en_route,waiting_for_charge_queue,in_charge_queue,charging,grounded,parked,queue_length,chargers_in_use,"
+                    "Test_flight,Test_charging,Test_waiting");
+    std::getline(csv, line);
+    EXPECT_EQ(line, "0,4,0,0,0,0,0,0,0,0,0,0");
+    std::getline(csv, line);
+    EXPECT_EQ(line, "20,4,0,0,0,0,0,0,0,80,0,0");
+    std::getline(csv, line);
+    EXPECT_EQ(line, "40,0,0,3,1,0,0,3,1,156,0,0");
+    // Final sample at the end of the run
+    std::getline(csv, line);
+    EXPECT_EQ(line, "45,0,0,3,1,0,0,3,1,156,5,15");
+    EXPECT_FALSE(std::getline(csv, line));
+}
+
+// Test the binary header and record layout of a tick engine run
+TEST(TelemetryTest, binary) {
+    const std::string path = testing::TempDir() + "telemetry_test.bin";
+    auto model = makeFlightModel();
+    vector<shared_ptr<Vehicle>> vehicles{shared_ptr<Vehicle>(new Vehicle(model))};
+    ChargingStation chargingStation(1);
+    RandomStream rng(1);
+    {
+        Telemetry telemetry(path, 1.0, {model});
+        runTickLoop(vehicles, chargingStation, nullptr, 1.0, 10.0, rng, &telemetry);
+    }
+
+    std::string data = readFile(path);
+    const size_t headerSize = 8 + 3 * 4 + 4 + 4;
+    const size_t recordSize = 8 + cNumberOfOperationStates * 8 + 2 * 8 + 3 * 8;
+    ASSERT_EQ(data.size(), headerSize + 11 * recordSize);
+    EXPECT_EQ(data.substr(0, 7), "JOBYTLM");
+    EXPECT_EQ(data.substr(24, 4), "Test");
+
+    // The last record has 10 minutes of flight
+    const char* last = data.data() + headerSize + 10 * recordSize;
+    double time;
+    double flight;
+    std::memcpy(&time, last, sizeof(time));
+    std::memcpy(&flight, last + recordSize - 3 * 8, sizeof(flight));
+    EXPECT_EQ(time, 10.0);
+    EXPECT_EQ(flight, 10.0);
+}
@@ -0,0 +1,25 @@
+#ifndef _TEST_MODELS_H
+#define _TEST_MODELS_H
+
+#include <memory>
+
+#include <Vehicle.h>
+
+// Model records shared by the tests, each test gets records of its own
+
+// A model with the given parameters and nothing flown yet
+inline shared_ptr<ModelData> makeModel(const ModelParameters& params) {
+    return shared_ptr<ModelData>(new ModelData({params, 0, 0, 0, 0}));
+}
+
+// A different value in every parameter, for tests that check they are carried through
+inline shared_ptr<ModelData> makeModel() {
+    return makeModel({"Test", 22.0, 33.0, 44.0, 55.0, 3, 0.66, 77.0});
+}
+
+// Flights of 40 minutes and charges of timeToCharge minutes, for tests that follow vehicles through them
+inline shared_ptr<ModelData> makeFlightModel(double timeToCharge = 10.0) {
+    return makeModel({"Test", 100.0, 100.0, timeToCharge, 1.5, 5, 0.1, 40.0});
+}
+
+#endif //_TEST_MODELS_H
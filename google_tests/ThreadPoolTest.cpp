@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+
+#include <ThreadPool.h>
+
+// Every task of every batch runs exactly once
+TEST(ThreadPoolTest, run) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+
+    std::vector<int> runs(1000, 0);
+    for (int batch = 0; batch < 10; ++batch) {
+        pool.run(runs.size(), [&](size_t task) {
+            ++runs[task];
+        });
+    }
+    for (int count : runs) {
+        EXPECT_EQ(count, 10);
+    }
+}
+
+// A single thread pool runs tasks in order on the calling thread
+TEST(ThreadPoolTest, singleThread) {
+    ThreadPool pool(1);
+    EXPECT_EQ(pool.size(), 1u);
+
+    std::vector<size_t> order;
+    pool.run(5, [&](size_t task) {
+        order.push_back(task);
+    });
+    EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
@@ -50,4 +50,31 @@ TEST(VehicleTest, setCharging) {
     testVehicle.setCharging();
     EXPECT_EQ(testVehicle.getOpState(), OperationState::charging);
     EXPECT_TRUE(testVehicle.isCharging());
-}
\ No newline at end of file
+}
+
+// Test the timeRemaining & advance methods used by the event engine
+TEST(VehicleTest, advance) {
+    auto testModel = shared_ptr<ModelData>(
+            new ModelData({{"Test", 22.0, 33.0, 44.0, 55.0, 3, 0.66, 77.0}, 5, 7, 11, 13}));
+    Vehicle testVehicle(testModel);
+    EXPECT_DOUBLE_EQ(testVehicle.timeRemaining(), 77.0);
+
+    testVehicle.advance(7.0);
+    EXPECT_EQ(testVehicle.getOpState(), OperationState::en_route);
+    EXPECT_DOUBLE_EQ(testVehicle.timeRemaining(), 70.0);
+    EXPECT_DOUBLE_EQ(testModel->totalFlightTime, 14.0);
+
+    testVehicle.advance(testVehicle.timeRemaining());
+    EXPECT_EQ(testVehicle.getOpState(), OperationState::waiting_for_charge_queue);
+    EXPECT_DOUBLE_EQ(testModel->totalFlightTime, 84.0);
+
+    testVehicle.setInWaitQueue();
+    testVehicle.advance(2.0);
+    EXPECT_DOUBLE_EQ(testModel->totalWaitingTime, 15.0);
+
+    testVehicle.setCharging();
+    EXPECT_DOUBLE_EQ(testVehicle.timeRemaining(), 44.0);
+    testVehicle.advance(44.0);
+    EXPECT_EQ(testVehicle.getOpState(), OperationState::en_route);
+    EXPECT_DOUBLE_EQ(testModel->totalChargingTime, 55.0);
+}
@@ -1,246 +1,204 @@
+#include <cmath>
+#include <cstring>
 #include <iostream>
-#include <vector>
-#include <map>
-#include <random>
+#include <string>
 
-#include "./Vehicle.h"
-#include "./ChargingStation.h"
+#include "./MonteCarlo.h"
+#include "./Profiler.h"
+#include "./Simulation.h"
+#include "./StaticFleet.h"
+#include "./Sweep.h"
 
-using std::vector;
 using std::cout;
+using std::cerr;
 using std::endl;
-using std::shared_ptr;
-using std::unique_ptr;
 
-// Vehicle model IDs
-enum ModelID {
-    alpha,
-    beta,
-    charlie,
-    delta,
-    echo,
-    count // For tracking the number of models
-};
-
-// Convent typedef
-typedef std::map<ModelID, shared_ptr<ModelData>> VehicleModelMap;
-
-// Get system time as a double
-double sysTime() {
-    struct timespec time_spec;
-    assert(clock_gettime(CLOCK_MONOTONIC_RAW, &time_spec) == 0);
-    double sys_time = time_spec.tv_sec + (time_spec.tv_nsec * 1e-9);
-    return sys_time;
-}
-
-// Function to initialize the various Vehicle "Models" in the simulation. In real life this could be data driven
-// based on the contents of setup files or something.
-void  initializeModels(VehicleModelMap& vehicleModels) {
-    // Define the specific Models (this could potentially be made data-driven)
-    // Alpha
-    shared_ptr<ModelData> alphaState(new ModelData {
-        {
-            "Alpha",
-            120.0,       // Speed (mph)
-            320.0,       // Battery Capacity (kWh)
-            0.6 * 60.0,  // Time to Charge (minutes)
-            1.6,         // Energy use at Cruse (kwh/mile)
-            4,           // Passenger Count
-            0.25,        // Fault probability / hour
-            (320.0 * 60.0) / (120.0 * 1.6) // Flight endurance (minutes), I could calculate this every time.
-        },
-        0, // Number in Fleet
-        0, // Accumulated Fleet Flight Time
-        0, // Accumulated Fleet Charging Time
-        0, // Accumulated Fleet Wait Time
-    });
-    vehicleModels[ModelID::alpha] = alphaState;
-
-    // Beta
-    shared_ptr<ModelData> betaState(new ModelData {
-        {
-            "Beta",
-            100.0,       // Speed (mph)
-            100.0,       // Battery Capacity (kWh)
-            0.2 * 60.0,  // Time to Charge (minutes)
-            1.5,         // Energy use at Cruse (kwh/mile)
-            5,           // Passenger Count
-            0.1,         // Fault probability / hour
-            (100.0 * 60.0) / (100.0 * 1.5) // Flight endurance (minutes), I could calculate this every time.
-        },
-        0, // Number in Fleet
-        0, // Accumulated Fleet Flight Time
-        0, // Accumulated Fleet Charging Time
-        0, // Accumulated Fleet Wait Time
-    });
-    vehicleModels[ModelID::beta] = betaState;
-
-    // Charlie
-    shared_ptr<ModelData> charlieState(new ModelData {
-        {
-            "Charlie",
-            160.0,       // Speed (mph)
-            220.0,       // Battery Capacity (kWh)
-            0.8 * 60.0,  // Time to Charge (minutes)
-            2.2,         // Energy use at Cruse (kwh/mile)
-            3,           // Passenger Count
-            0.05,        // Fault probability / hour
-            (220.0 * 60.0) / (160.0 * 2.2) // Flight endurance (minutes), I could calculate this every time.
-        },
-        0, // Number in Fleet
-        0, // Accumulated Fleet Flight Time
-        0, // Accumulated Fleet Charging Time
-        0, // Accumulated Fleet Wait Time
-    });
-    vehicleModels[ModelID::charlie] = charlieState;
-
-    // Delta
-    shared_ptr<ModelData> deltaState(new ModelData {
-        {
-            "Delta",
-            90.0,       // Speed (mph)
-            120.0,       // Battery Capacity (kWh)
-            0.62 * 60.0,  // Time to Charge (minutes)
-            0.8,         // Energy use at Cruse (kwh/mile)
-            2,           // Passenger Count
-            0.22,        // Fault probability / hour
-            (120.0 * 60.0) / (120.0 * 1.6) // Flight endurance (minutes), I could calculate this every time.
-        },
-        0, // Number in Fleet
-        0, // Accumulated Fleet Flight Time
-        0, // Accumulated Fleet Charging Time
-        0, // Accumulated Fleet Wait Time
-    });
-    vehicleModels[ModelID::delta] = deltaState;
-
-    // Echo
-    shared_ptr<ModelData> echoState(new ModelData {
-        {
-            "Echo",
-            30.0,        // Speed (mph)
-            150.0,       // Battery Capacity (kWh)
-            0.3 * 60.0,  // Time to Charge (minutes)
-            5.8,         // Energy use at Cruse (kwh/mile)
-            2,           // Passenger Count
-            0.61,        // Fault probability / hour
-            (150.0 * 60.0) / (30.0 * 5.8) // Flight endurance (minutes), I could calculate this every time.
-        }, // Number in Fleet
-        0, // Number in Fleet
-        0, // Accumulated Fleet Flight Time
-        0, // Accumulated Fleet Charging Time
-        0, // Accumulated Fleet Wait Time
-    });
-    vehicleModels[ModelID::echo] = echoState;
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " [--scenario file] [--<setting> value ...]" << endl;
+    cout << "  --scenario file     Load models and settings from a scenario file (see Scenario.h)" << endl;
+    cout << "  --engine tick       Iterate every vehicle on each increment (default)" << endl;
+    cout << "  --engine event      Jump from one vehicle state change to the next" << endl;
+    cout << "  --engine fleet      Iterate a structure-of-arrays fleet on each increment" << endl;
+    cout << "  --engine static     Same as fleet, specialized for the built in models at build time (see StaticFleet.h)" << endl;
+    cout << "  --fast-forward on|off  Jump over passes without state changes, tick engine with fixed steps (default on)" << endl;
+    cout << "  --threads n         Threads for the fleet engine, 0 for one per core (default 1)" << endl;
+    cout << "  --duration minutes  World time to run (default 180)" << endl;
+    cout << "  --step clock|fixed  Step with the system clock (default) or a fixed increment" << endl;
+    cout << "  --increment minutes World time per fixed step (default 0.01)" << endl;
+    cout << "  --tick-rate n       Steps per second when stepping with the clock (default 100)" << endl;
+    cout << "  --time-scale minutes  World time per second when stepping with the clock (default 1)" << endl;
+    cout << "  --max-catch-up n    Most ticks one clock step covers after falling behind (default 10)" << endl;
+    cout << "  --fleet-size n      Number of vehicles (default 20)" << endl;
+    cout << "  --vehicle-results on|off  Print the results of every vehicle as well as every model (default on)" << endl;
+    cout << "  --chargers n        Number of charging slots per station (default 3)" << endl;
+    cout << "  --stations n        Number of charging stations, fleet engine only (default 1)" << endl;
+    cout << "  --routing policy    Station for a landed vehicle: nearest (default), least_queued or round_robin" << endl;
+    cout << "  --vertiports n      Fly trips between n vertiports, the first --stations of them have the chargers," << endl;
+    cout << "                      needs the battery model (see Geography.h)" << endl;
+    cout << "  --vertiport-area miles  Side of the square the vertiports are spread over (default 50)" << endl;
+    cout << "  --faults on|off     Simulate faults and maintenance, fleet engine only (default off)" << endl;
+    cout << "  --maintenance-time minutes  Time grounded after a fault (default 60)" << endl;
+    cout << "  --battery on|off    Model state of charge, partial charges and queueing by need, fleet engine only (default off)" << endl;
+    cout << "  --trip-time minutes  Flight time of each trip with the battery model, a value or shortest:longest" << endl;
+    cout << "                      (default fly until the battery is flat)" << endl;
+    cout << "  --charge-to fraction  Charge up to this fraction of a full battery, or enough for the next trip (default 1)" << endl;
+    cout << "  --telemetry file    Write a time series of the run, CSV if file ends in .csv (tick and fleet engines)" << endl;
+    cout << "  --telemetry-interval minutes  World time between telemetry samples (default 1)" << endl;
+    cout << "  --checkpoint file   Save the state of a fleet engine run to file (see Checkpoint.h)" << endl;
+    cout << "  --checkpoint-at minutes  World time to save the checkpoint at (default end of run)" << endl;
+    cout << "  --restore file      Continue a fleet engine run from a checkpoint, with the same scenario" << endl;
+    cout << "  --profile-trace file  Write a Chrome trace of the run's phases, needs a -DJOBY_PROFILE=ON build" << endl;
+    cout << "  --demand file       Park vehicles between trips and fly them for trip requests by time of day," << endl;
+    cout << "                      fleet engine only (see Demand.h)" << endl;
+    cout << "  --live name         Publish snapshots of the run to shared memory for joby_monitor (tick and fleet engines)" << endl;
+    cout << "  --live-interval minutes  World time between live snapshots (default 1)" << endl;
+    cout << "  --sweep-chargers list  Run a sweep over charging slots, e.g. 1:4,8 (see Sweep.h)" << endl;
+    cout << "  --sweep-fleet-size list  Run a sweep over fleet sizes, e.g. 100:1000:100" << endl;
+    cout << "  --sweep-weights sets    Run a sweep over model weights, e.g. \"1 1 1 1 1, 4 1 1 1 1\"" << endl;
+    cout << "  --sweep-max-wait minutes  Stop a sweep run once its average wait is sure to end up above this" << endl;
+    cout << "  --sweep-output file  Write the sweep results to a CSV file (default standard output)" << endl;
+    cout << "  --seed n            Random number seed (default random)" << endl;
+    cout << "  --replications n    Run n seeded fleet engine replications and print statistics (default 1)" << endl;
 }
 
-// Runs the actual simulation
-// In this incarnation the simulation is a single threaded loop through a vector
-// of randomly select vehicle models.
-//
-// Params:
-//   useRealTime - If true, use the system clock to calculate increment time delta so that
-//                 each system second is 1 sim minutes.
-//                 If false, each pass through the main loop increments world time by 0.6 seconds.
-//   runTime     - Number of world time minutes to run the simulation
-void runSimulation(bool useRealTime, double runTime) {
-    // We're going to want some randomness
-    std::random_device rd;
-    std::default_random_engine rng(rd());
-
-    // Create a map from Model ModelID to ModelData records
-    VehicleModelMap modelStates;
-    initializeModels(modelStates);
-
-    // Generate the Fleet
-    // Create a random assortment of vehicles and store in a vector
-    std::uniform_int_distribution<unsigned int> dist(0, ModelID::count-1);
-    vector<shared_ptr<Vehicle>> vehicles;
-    for (unsigned int vehicleCount=0; vehicleCount < 20;) {
-        ModelID nextModel = static_cast<ModelID>(dist(rng));
+int main(int argc, char* argv[]) {
+    Scenario scenario = defaultScenario();
+    std::string error;
 
-        // If there's an entry for the model in the model map add a new vehicle to the fleet
-        if (modelStates.count(nextModel) != 0) { // Just making sure there's a entry for this model
-            shared_ptr<ModelData> model = modelStates[nextModel];
-            vehicles.push_back(shared_ptr<Vehicle>(new Vehicle(model)));
-            ++(model->fleetCount);
-            ++vehicleCount;
+    // Load the scenario file first so the other options override it wherever they are
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--scenario") == 0 && !loadScenario(argv[i + 1], scenario, error)) {
+            cerr << error << endl;
+            return 1;
         }
     }
 
-    // Generate the charging station
-    // Assumption: There is only one charging location that all vehicles share after every trip.
-    ChargingStation chargingStation(3);
-
-    // Simulation loop:
-    double increment = 0.01; // The value only maters if we're not using the system clock
-    double currentTime = 0.0; // Start currentTime delta
-    double now = sysTime(); // Only used when using the real time clock;
-    double startTime = now;
-
-    unsigned long totalIterations = 0; // Just here for debugging
-    // Main simulation loop, we're done when it is over.
-    while (currentTime < runTime) {
-        if (useRealTime) {
-            // We're using the system clock to calculate the next increment
-            double lastTime = now;
-            now = sysTime();
-            increment = now - lastTime;
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option.compare(0, 2, "--") != 0 || i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (option == "--scenario") {
+            continue;
         }
 
-        // Shuffle the vector of vehicle so we're not always incrementing them in the same order.
-        std::shuffle(vehicles.begin(), vehicles.end(), rng);
-
-        // Iterate through vehicles.
-        // This could potentially change the vehicle's state from
-        // "en_route" -> "waiting_for_charge_queue" -> "in_charge_queue",
-        // or "charging" -> "en_route".
-        for(shared_ptr<Vehicle> &v : vehicles) {
-            v->iterate(increment);
-            // Vehicles don't know about the charging station and the charging station doesn't know
-            // about vehicles it's not yet managing (just exited "en_route" state).
-            if (v->isWaitingForQueue()) {
-                // Tell the charging station about the vehicle - which changes vehicle state from
-                // "waiting_for_charge_queue" to "in_charge_queue"
-                chargingStation.addVehicle(v);
+        // --fleet-size is the fleet_size setting
+        std::string key = option.substr(2);
+        for (char& c : key) {
+            if (c == '-') {
+                c = '_';
             }
         }
+        if (!applySetting(scenario, key, value, error)) {
+            cerr << error << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
 
-        // Iterate the chargingStation which will fill charging slots with queued vehicles if there are
-        // any empty slots and queued vehicles.
-        //
-        // This could potentially change some vehicle states from
-        // "in_charge_queue" to "charging"
-        chargingStation.iterate();
-
-        // Increment the currentTime for the next iteration.
-        currentTime += increment;
+    if (scenario.engine != SimulationEngine::fleet_engine && scenario.replications == 1) {
+        if (scenario.numberOfStations > 1) {
+            cerr << "more than one station needs --engine fleet" << endl;
+            return 1;
+        }
+        if (scenario.faults) {
+            cerr << "faults need --engine fleet" << endl;
+            return 1;
+        }
+        if (scenario.battery) {
+            cerr << "the battery model needs --engine fleet" << endl;
+            return 1;
+        }
+    }
 
-        // For debugging
-        ++totalIterations;
+    if (scenario.engine == SimulationEngine::static_engine && scenario.replications == 1) {
+        if (!DefaultStaticFleet::hasModels(scenario.models)) {
+            cerr << "--engine static only runs the built in models" << endl;
+            return 1;
+        }
     }
-    // Print some run data
-    double totalRunTime = sysTime() - startTime;
-    cout << "Simulation finished, total-run-time(seconds)/total-iterations: " << totalRunTime << "/" << totalIterations << endl << endl;
 
-    // Done with the simulation, now print out results.
-    // Print vehicle stats
-    cout << "Per Vehicle Stats:" << endl;
-    for (shared_ptr<Vehicle> v: vehicles) {
-        v->printResult();
+    // Vertiports take the place of trip_time, and the map isn't part of a checkpoint
+    if (scenario.numberOfVertiports > 0) {
+        if (!scenario.battery) {
+            cerr << "vertiports need the battery model" << endl;
+            return 1;
+        }
+        if (std::isfinite(scenario.maximumTripTime)) {
+            cerr << "vertiports set the trip times, drop trip_time" << endl;
+            return 1;
+        }
+        if (scenario.numberOfStations > scenario.numberOfVertiports) {
+            cerr << "more stations than vertiports" << endl;
+            return 1;
+        }
+        if (!scenario.checkpointPath.empty() || !scenario.restorePath.empty()) {
+            cerr << "checkpoints can't be used with vertiports" << endl;
+            return 1;
+        }
     }
 
-    // Print model stats
-    cout << endl << "Per Model Stats:" << endl;
-    for(auto model: modelStates) {
-        model.second->prinResult();
+    bool sweep = !scenario.sweepChargers.empty() || !scenario.sweepFleetSizes.empty() ||
+                 !scenario.sweepWeights.empty();
+
+    if ((!scenario.checkpointPath.empty() || !scenario.restorePath.empty()) &&
+        (scenario.engine != SimulationEngine::fleet_engine || sweep || scenario.replications > 1)) {
+        cerr << "checkpoints need --engine fleet and a single run" << endl;
+        return 1;
     }
 
-}
+    // The fleet engine keeps a one byte model index per vehicle, the tick and event engines take any
+    // number of models
+    if (scenario.models.size() > FleetState::cMaxModels &&
+        (scenario.engine == SimulationEngine::fleet_engine || scenario.engine == SimulationEngine::static_engine ||
+         sweep || scenario.replications > 1)) {
+        cerr << "more than " << FleetState::cMaxModels << " models need --engine tick or event" << endl;
+        return 1;
+    }
 
-//TODO: parameterize main to input runtime and iteration type
-int main() {
-    double runTime = 60.0 * 3.0; // Run time is in minutes (60.0 * 3.0 == 180 minutes or 3 hours world time)
-    bool useSysClock = true; // boolean to make iteration size based on clock time or simple world time delta
-    runSimulation(useSysClock, runTime);
+    // Only single runs are profiled
+    if (!scenario.profileTracePath.empty() && (!cProfilingBuild || sweep || scenario.replications > 1)) {
+        cerr << "profile_trace needs a build configured with -DJOBY_PROFILE=ON and a single run" << endl;
+        return 1;
+    }
+    // The requests waiting for a vehicle aren't part of a checkpoint
+    if (!scenario.demandPath.empty() &&
+        (scenario.engine != SimulationEngine::fleet_engine || sweep || scenario.replications > 1 ||
+         !scenario.checkpointPath.empty() || !scenario.restorePath.empty())) {
+        cerr << "demand needs --engine fleet, a single run and no checkpoints" << endl;
+        return 1;
+    }
+    // Telemetry samples the passes of one run
+    if (!scenario.telemetryPath.empty() &&
+        (sweep || scenario.replications > 1 || (scenario.engine != SimulationEngine::tick_engine &&
+                                                scenario.engine != SimulationEngine::fleet_engine))) {
+        cerr << "telemetry needs --engine tick or fleet and a single run" << endl;
+        return 1;
+    }
+    // Sweeps and replications run many fleets at once, there is no one run to watch
+    if (!scenario.liveName.empty() &&
+        (sweep || scenario.replications > 1 || (scenario.engine != SimulationEngine::tick_engine &&
+                                                scenario.engine != SimulationEngine::fleet_engine))) {
+        cerr << "live needs --engine tick or fleet and a single run" << endl;
+        return 1;
+    }
+    if (sweep) {
+        for (const std::vector<double>& weights : scenario.sweepWeights) {
+            if (weights.size() != scenario.models.size()) {
+                cerr << "sweep_weights needs " << scenario.models.size() << " weights in each set" << endl;
+                return 1;
+            }
+        }
+        if (!runSweep(scenario, error)) {
+            cerr << error << endl;
+            return 1;
+        }
+    } else if (scenario.replications > 1) {
+        runMonteCarlo(scenario);
+    } else {
+        runSimulation(scenario);
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "./LiveExport.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+// Watches a simulation run with --live name from another process, printing each new snapshot
+// (see LiveExport.h). Reading never holds up the simulation.
+
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " name [--interval seconds] [--once]" << endl;
+    cout << "  name                Shared memory segment the simulation was given with --live" << endl;
+    cout << "  --interval seconds  Wall clock time between reads (default 1)" << endl;
+    cout << "  --once              Print the latest snapshot and exit" << endl;
+}
+
+void printSnapshot(const LiveSnapshot& snapshot, const vector<std::string>& labels) {
+    cout << "Live, time(mins)/snapshot" << (snapshot.finished ? ", finished" : "") << ": "
+         << snapshot.time << "/" << snapshot.sequence / 2 << "\n";
+    cout << "  States";
+    for (unsigned int state = 0; state < cNumberOfOperationStates; ++state) {
+        cout << (state == 0 ? ", " : "/") << operationStateName(state);
+    }
+    for (unsigned int state = 0; state < cNumberOfOperationStates; ++state) {
+        cout << (state == 0 ? ": " : "/") << snapshot.stateCounts[state];
+    }
+    cout << "\n";
+    cout << "  Chargers, waiting/charging: " << snapshot.waiting << "/" << snapshot.charging << "\n";
+    for (size_t m = 0; m < labels.size(); ++m) {
+        const ModelTotals& totals = snapshot.modelTotals[m];
+        cout << "  " << labels[m] << ", flight/charging/waiting(mins): " << totals.totalFlightTime << "/"
+             << totals.totalChargingTime << "/" << totals.totalWaitingTime << "\n";
+    }
+    cout << std::flush;
+}
+
+int main(int argc, char* argv[]) {
+    std::string name;
+    double interval = 1.0;
+    bool once = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--once") {
+            once = true;
+        } else if (option == "--interval" && i + 1 < argc) {
+            char* end;
+            interval = std::strtod(argv[++i], &end);
+            if (*end != '\0' || !(interval > 0.0)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (name.empty() && option.compare(0, 2, "--") != 0) {
+            name = option;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (name.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    LiveReader reader;
+    std::string error;
+    if (!reader.open(name, error)) {
+        cerr << error << endl;
+        return 1;
+    }
+    cout << std::fixed << std::setprecision(3);
+
+    // Only snapshots that are new since the last read are printed, the run has ended once one is finished
+    uint64_t lastSequence = 0;
+    LiveSnapshot snapshot;
+    while (true) {
+        bool read = reader.read(snapshot);
+        if (!read) {
+            cerr << name << ": no consistent snapshot, the simulation is publishing too often" << endl;
+        } else if (snapshot.sequence != lastSequence || once) {
+            printSnapshot(snapshot, reader.getLabels());
+            lastSequence = snapshot.sequence;
+        }
+        if (once) {
+            return read ? 0 : 1;
+        }
+        if (read && snapshot.finished) {
+            return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+    }
+}